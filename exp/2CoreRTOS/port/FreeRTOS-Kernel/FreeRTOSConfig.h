@@ -41,11 +41,16 @@
  *----------------------------------------------------------*/
 
 /* Scheduler Related */
+/* Settings wrapped in #ifndef can be overridden per build, see variants.cmake */
 #define configUSE_PREEMPTION                    1
-#define configUSE_TICKLESS_IDLE                 1   
+#ifndef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE                 1
+#endif
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     0
+#ifndef configTICK_RATE_HZ
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+#endif
 #define configMAX_PRIORITIES                    32
 #define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 256
 #define configUSE_16_BIT_TICKS                  0
@@ -59,11 +64,14 @@
 #define configUSE_COUNTING_SEMAPHORES           1
 #define configQUEUE_REGISTRY_SIZE               8
 #define configUSE_QUEUE_SETS                    1
+#ifndef configUSE_TIME_SLICING
 #define configUSE_TIME_SLICING                  1
+#endif
 #define configUSE_NEWLIB_REENTRANT              0
 // todo need this for lwip FreeRTOS sys_arch to compile
 #define configENABLE_BACKWARD_COMPATIBILITY     1
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   4
 
 /* System */
 #define configSTACK_DEPTH_TYPE                  uint32_t
@@ -76,12 +84,18 @@
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
+#ifndef configCHECK_FOR_STACK_OVERFLOW
 #define configCHECK_FOR_STACK_OVERFLOW          1
+#endif
 #define configUSE_MALLOC_FAILED_HOOK            0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+/* Run time is the 64 bit microsecond timer, so it never wraps */
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_TYPE             uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        ullTraceRunTimeUs()
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
@@ -105,7 +119,9 @@
 // Multi Core
 #define configNUMBER_OF_CORES                   2
 #define configTICK_CORE                         0
+#ifndef configRUN_MULTIPLE_PRIORITIES
 #define configRUN_MULTIPLE_PRIORITIES           1
+#endif
 #define configUSE_CORE_AFFINITY                 1
 #define configNUM_CORES 					    configNUMBER_OF_CORES  //SDK still relies on this
 #define configUSE_PASSIVE_IDLE_HOOK			    0
@@ -138,6 +154,7 @@ to exclude the API function. */
 #define INCLUDE_xQueueGetMutexHolder            1
 
 /* A header file that defines trace macro can be included here. */
+#include "traceHooks.h"
 
 
 #ifdef __cplusplus
@@ -0,0 +1,131 @@
+/*
+ * traceHooks.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "FreeRTOS.h"
+#include "traceHooks.h"
+#include "hardware/timer.h"
+#include "hardware/sync.h"
+
+volatile TraceTask_t xTraceTasks[ TRACE_MAX_TASKS ];
+volatile TraceMigration_t xTraceLog[ configNUMBER_OF_CORES ][ TRACE_LOG_LEN ];
+volatile uint32_t ulTraceLogHead[ configNUMBER_OF_CORES ] = { 0 };
+volatile uint32_t ulTraceSwitches[ configNUMBER_OF_CORES ] = { 0 };
+
+#if TRACE_RECORDER
+volatile TraceEvent_t xTraceEvents[ configNUMBER_OF_CORES ][ TRACE_EVENTS_LEN ];
+volatile uint32_t ulTraceEventHead[ configNUMBER_OF_CORES ] = { 0 };
+static volatile uint32_t ulTraceRecording = 1;
+#endif
+
+/* Task running on each core and when it was switched in */
+static volatile uint32_t ulRunning[ configNUMBER_OF_CORES ] = { 0 };
+static volatile uint32_t ulRunningSinceUs[ configNUMBER_OF_CORES ] = { 0 };
+
+void vTraceTaskSwitchedIn( uint32_t ulTaskNumber ){
+	uint32_t ulCore = portGET_CORE_ID();
+	uint32_t ulNow = time_us_32();
+
+	/* Charge the task leaving this core with its time here */
+	uint32_t ulPrev = ulRunning[ ulCore ];
+	ulTraceSwitches[ ulCore ]++;
+	if( ( ulPrev > 0 ) && ( ulPrev < TRACE_MAX_TASKS ) ){
+		xTraceTasks[ ulPrev ].ulResidentUs[ ulCore ] += ulNow - ulRunningSinceUs[ ulCore ];
+	}
+	/* Since before task, see ulTraceGetResidentUs */
+	ulRunningSinceUs[ ulCore ] = ulNow;
+	ulRunning[ ulCore ] = ulTaskNumber;
+#if TRACE_RECORDER
+	vTraceRecord( TRACE_EV_SWITCH_IN, ulTaskNumber );
+#endif
+
+	if( ( ulTaskNumber == 0 ) || ( ulTaskNumber >= TRACE_MAX_TASKS ) ){
+		return;
+	}
+
+	volatile TraceTask_t *pxTask = &xTraceTasks[ ulTaskNumber ];
+	uint8_t ucLast = pxTask->ucLastCore;
+	if( ( ucLast != 0 ) && ( ucLast != ulCore + 1 ) ){
+		pxTask->ulMigrations++;
+
+		uint32_t ulHead = ulTraceLogHead[ ulCore ];
+		volatile TraceMigration_t *pxEvent = &xTraceLog[ ulCore ][ ulHead & ( TRACE_LOG_LEN - 1 ) ];
+		pxEvent->ulTimeUs = ulNow;
+		pxEvent->ucTaskNumber = ( uint8_t ) ulTaskNumber;
+		pxEvent->ucFrom = ucLast - 1;
+		pxEvent->ucTo = ( uint8_t ) ulCore;
+		ulTraceLogHead[ ulCore ] = ulHead + 1;
+	}
+	pxTask->ucLastCore = ( uint8_t ) ( ulCore + 1 );
+}
+
+uint32_t ulTraceGetResidentUs( uint32_t ulTaskNumber, uint32_t ulCore ){
+	uint32_t ulResident;
+	uint32_t ulSince;
+	uint32_t ulRunningTask;
+
+	/* Retry if the core switched while the three were read */
+	do {
+		ulResident = xTraceTasks[ ulTaskNumber ].ulResidentUs[ ulCore ];
+		ulRunningTask = ulRunning[ ulCore ];
+		ulSince = ulRunningSinceUs[ ulCore ];
+	} while( ulResident != xTraceTasks[ ulTaskNumber ].ulResidentUs[ ulCore ] );
+
+	if( ulRunningTask == ulTaskNumber ){
+		ulResident += time_us_32() - ulSince;
+	}
+	return ulResident;
+}
+
+#if TRACE_RECORDER
+
+void vTraceTaskSwitchedOut( void ){
+	vTraceRecord( TRACE_EV_SWITCH_OUT, ulRunning[ portGET_CORE_ID() ] );
+}
+
+void vTraceRecord( uint8_t ucType, uint32_t ulArg ){
+	if( ulTraceRecording == 0 ){
+		return;
+	}
+	uint32_t ulCore = portGET_CORE_ID();
+
+	/* Only a nested interrupt on this core can race for the slot */
+	uint32_t ulIrq = save_and_disable_interrupts();
+	uint32_t ulHead = ulTraceEventHead[ ulCore ];
+	volatile TraceEvent_t *pxEvent = &xTraceEvents[ ulCore ][ ulHead & ( TRACE_EVENTS_LEN - 1 ) ];
+	pxEvent->ulTimeUs = time_us_32();
+	pxEvent->ucType = ucType;
+	pxEvent->ucTask = ( uint8_t ) ulRunning[ ulCore ];
+	pxEvent->usArg = ( uint16_t ) ulArg;
+	ulTraceEventHead[ ulCore ] = ulHead + 1;
+	restore_interrupts( ulIrq );
+}
+
+void vTraceIsrEnter( void ){
+	vTraceRecord( TRACE_EV_ISR_ENTER, __get_current_exception() );
+}
+
+void vTraceIsrExit( void ){
+	vTraceRecord( TRACE_EV_ISR_EXIT, __get_current_exception() );
+}
+
+void vTraceRecorderEnable( uint32_t ulOn ){
+	ulTraceRecording = ulOn;
+}
+
+#else
+
+void vTraceTaskSwitchedOut( void ){}
+void vTraceRecord( uint8_t ucType, uint32_t ulArg ){}
+void vTraceIsrEnter( void ){}
+void vTraceIsrExit( void ){}
+void vTraceRecorderEnable( uint32_t ulOn ){}
+
+#endif /* TRACE_RECORDER */
+
+uint64_t ullTraceRunTimeUs( void ){
+	return time_us_64();
+}
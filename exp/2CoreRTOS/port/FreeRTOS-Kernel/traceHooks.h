@@ -0,0 +1,181 @@
+/*
+ * traceHooks.h
+ *
+ * FreeRTOS trace macros used to follow tasks between cores. Included
+ * from FreeRTOSConfig.h.
+ *
+ * Tasks are identified by their task number, which Agent sets to its
+ * registry slot + 1. Tasks left at number 0 (idle, timer, main) and
+ * numbers of TRACE_MAX_TASKS or more are not followed.
+ *
+ * The recorder keeps the last TRACE_EVENTS_LEN scheduler events on each
+ * core: switches, notifications, queue operations and interrupts. Each
+ * core writes only its own ring, so no lock is shared between cores.
+ * TraceRecorder prints the rings for tools/trace_chrome.py. Build with
+ * TRACE_RECORDER=0 to leave the hooks out.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef TRACEHOOKS_H_
+#define TRACEHOOKS_H_
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TRACE_MAX_TASKS		24		//Agent registry slots + 1, then other tasks
+#define TRACE_LOG_LEN		16		//Migrations kept per core, power of two
+
+#ifndef TRACE_RECORDER
+#define TRACE_RECORDER		1
+#endif
+#ifndef TRACE_EVENTS_LEN
+#define TRACE_EVENTS_LEN	1024	//Events kept per core, power of two
+#endif
+
+/* Event types, tools/trace_chrome.py depends on these values */
+#define TRACE_EV_MARK			0	//Arg from the caller
+#define TRACE_EV_SWITCH_IN		1	//Arg is the task number
+#define TRACE_EV_SWITCH_OUT		2
+#define TRACE_EV_NOTIFY			3	//Arg is the task number notified
+#define TRACE_EV_NOTIFY_WAIT	4	//Arg is the notification index
+#define TRACE_EV_QUEUE_SEND		5	//Arg is the low 16 bits of the queue address
+#define TRACE_EV_QUEUE_RECEIVE	6
+#define TRACE_EV_QUEUE_BLOCK_SEND		7
+#define TRACE_EV_QUEUE_BLOCK_RECEIVE	8
+#define TRACE_EV_ISR_ENTER		9	//Arg is the exception number
+#define TRACE_EV_ISR_EXIT		10
+
+/* 8 bytes, task is the one running on the core when recorded */
+typedef struct {
+	uint32_t ulTimeUs;
+	uint8_t  ucType;
+	uint8_t  ucTask;
+	uint16_t usArg;
+} TraceEvent_t;
+
+typedef struct {
+	uint32_t ulTimeUs;
+	uint8_t  ucTaskNumber;
+	uint8_t  ucFrom;
+	uint8_t  ucTo;
+} TraceMigration_t;
+
+typedef struct {
+	uint32_t ulMigrations;
+	uint32_t ulResidentUs[ configNUMBER_OF_CORES ];
+	uint8_t  ucLastCore;		/* Core + 1, 0 before the first run */
+} TraceTask_t;
+
+/* Per task stats, a task is only switched in on one core at a time */
+extern volatile TraceTask_t xTraceTasks[ TRACE_MAX_TASKS ];
+
+/* Migration ring per core, written by the core the task moved to */
+extern volatile TraceMigration_t xTraceLog[ configNUMBER_OF_CORES ][ TRACE_LOG_LEN ];
+extern volatile uint32_t ulTraceLogHead[ configNUMBER_OF_CORES ];
+
+/* Context switches onto each core, counted with or without the recorder */
+extern volatile uint32_t ulTraceSwitches[ configNUMBER_OF_CORES ];
+
+/* Event ring per core, head counts every event ever recorded */
+extern volatile TraceEvent_t xTraceEvents[ configNUMBER_OF_CORES ][ TRACE_EVENTS_LEN ];
+extern volatile uint32_t ulTraceEventHead[ configNUMBER_OF_CORES ];
+
+/***
+ * Called from the scheduler with the task chosen to run on this core
+ * @param ulTaskNumber
+ */
+void vTraceTaskSwitchedIn( uint32_t ulTaskNumber );
+
+/***
+ * Time a task has run on a core, including the slice it is in now.
+ * The resident counters alone are only charged at the next switch.
+ * @param ulTaskNumber - below TRACE_MAX_TASKS
+ * @param ulCore
+ * @return us, wraps after 71 minutes
+ */
+uint32_t ulTraceGetResidentUs( uint32_t ulTaskNumber, uint32_t ulCore );
+
+/***
+ * Called from the scheduler before the running task leaves this core
+ */
+void vTraceTaskSwitchedOut( void );
+
+/***
+ * Add an event to this core's ring, safe from tasks and interrupts
+ * @param ucType - TRACE_EV_
+ * @param ulArg - truncated to 16 bits
+ */
+void vTraceRecord( uint8_t ucType, uint32_t ulArg );
+
+/***
+ * Mark the start and end of an interrupt handler. Used by the port
+ * where it supports traceISR_ENTER, application handlers call them
+ * directly.
+ */
+void vTraceIsrEnter( void );
+void vTraceIsrExit( void );
+
+/***
+ * Start or stop recording events on both cores, the rings are kept
+ * @param ulOn
+ */
+void vTraceRecorderEnable( uint32_t ulOn );
+
+/***
+ * Run time stats clock
+ * @return us since boot
+ */
+uint64_t ullTraceRunTimeUs( void );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#define traceTASK_SWITCHED_IN()		vTraceTaskSwitchedIn( \
+		uxTaskGetTaskNumber( xTaskGetCurrentTaskHandleForCore( portGET_CORE_ID() ) ) )
+
+#if TRACE_RECORDER
+#define traceTASK_SWITCHED_OUT()	vTraceTaskSwitchedOut()
+
+/* pxTCB is the task being notified in each of the notify functions */
+#define traceTASK_NOTIFY( uxIndexToNotify )	\
+		vTraceRecord( TRACE_EV_NOTIFY, uxTaskGetTaskNumber( ( TaskHandle_t ) pxTCB ) )
+#define traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify )	\
+		vTraceRecord( TRACE_EV_NOTIFY, uxTaskGetTaskNumber( ( TaskHandle_t ) pxTCB ) )
+#define traceTASK_NOTIFY_GIVE_FROM_ISR( uxIndexToNotify )	\
+		vTraceRecord( TRACE_EV_NOTIFY, uxTaskGetTaskNumber( ( TaskHandle_t ) pxTCB ) )
+#define traceTASK_NOTIFY_TAKE( uxIndexToWaitOn )	\
+		vTraceRecord( TRACE_EV_NOTIFY_WAIT, ( uxIndexToWaitOn ) )
+#define traceTASK_NOTIFY_WAIT( uxIndexToWaitOn )	\
+		vTraceRecord( TRACE_EV_NOTIFY_WAIT, ( uxIndexToWaitOn ) )
+
+/* Semaphores and mutexes are queues, give and take show as send and receive */
+#define traceQUEUE_SEND( pxQueue )	\
+		vTraceRecord( TRACE_EV_QUEUE_SEND, ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )	\
+		vTraceRecord( TRACE_EV_QUEUE_SEND, ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+#define traceQUEUE_RECEIVE( pxQueue )	\
+		vTraceRecord( TRACE_EV_QUEUE_RECEIVE, ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )	\
+		vTraceRecord( TRACE_EV_QUEUE_RECEIVE, ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )	\
+		vTraceRecord( TRACE_EV_QUEUE_BLOCK_SEND, ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )	\
+		vTraceRecord( TRACE_EV_QUEUE_BLOCK_RECEIVE, ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+
+#define traceISR_ENTER()				vTraceIsrEnter()
+#define traceISR_EXIT()					vTraceIsrExit()
+#define traceISR_EXIT_TO_SCHEDULER()	vTraceIsrExit()
+#endif /* TRACE_RECORDER */
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TRACEHOOKS_H_ */
@@ -22,11 +22,62 @@ extern "C"
 /*TSTVARIABLESSTART*/
 
 #define TSTNAME "MyDevice"
-#define TSTMAXSIZE 100
+#define TSTMAXSIZE 768
+#define TST_MAX_AGENTS 16
+#define TST_METRIC_SLOTS 48
 
 typedef struct __attribute__((packed)) {
-	uint32_t      core0Count;
-	uint32_t      core1Count;
+	uint8_t       state;             // eTaskState, 0xFF when not running
+	uint8_t       cpu;               // Share of one core in half percent
+	uint16_t      stackFree;         // Stack high water in words
+	uint16_t      stackSize;         // Allocated stack in words
+	uint8_t       stackUsed;         // % of stack ever used
+	uint16_t      loopRate;          // Heartbeats per sec
+	uint8_t       restarts;
+	uint8_t       flags;             // bit0 exited, bit1 stalled, bit2 stack warn
+} TST_AgentStat;
+
+typedef struct __attribute__((packed)) {
+	uint8_t       slots;             // Export slots registered
+	uint8_t       first;             // Slot of values[0]
+	uint8_t       count;             // Valid entries in values
+	uint8_t       seq;               // Bumped on every publish
+	uint32_t      values[TST_METRIC_SLOTS];
+} TST_MetricPage;
+
+typedef struct __attribute__((packed)) {
+	// Pipeline, one entry per stage or link
+	uint16_t      pipeRate[6];       // blocks per sec x100
+	uint16_t      pipeBusy[6];       // per mille
+	uint8_t       pipeDepth[6];
+	uint8_t       pipeDepthHigh[6];
+	uint32_t      pipeErrors;
+
+	// Agent supervisor, indexed by registry slot
+	uint8_t       agentCount;
+	TST_AgentStat agents[TST_MAX_AGENTS];
+
+	// Scheduler fairness across the Workers
+	uint16_t      fairness;          // Jain index of last window, per mille
+	uint16_t      fairnessTotal;     // Jain index since start, per mille
+	uint16_t      readyLen[2];       // Mean ready tasks per core x100
+	uint16_t      waitShare[4];      // Runnable but not running, per mille
+
+	// TST request to response latency, us
+	uint32_t      tstRequests;
+	uint32_t      tstLatP50;
+	uint32_t      tstLatP99;
+	uint32_t      tstLatMax;
+
+	// Core migrations, indexed by agent registry slot
+	uint32_t      migrations;        // Total since boot
+	uint16_t      migRate[TST_MAX_AGENTS];    // Migrations per sec
+	uint8_t       core1Share[TST_MAX_AGENTS]; // % of run time on core 1
+
+	// Metric registry, paged when more slots are registered than fit.
+	// Slot names and types are sent as monitor messages. CPU use is
+	// published here as the cpu.* gauges.
+	TST_MetricPage metrics;
 } TST_Variables;
 
 /*TSTVARIABLESEND*/
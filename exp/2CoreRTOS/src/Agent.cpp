@@ -7,14 +7,17 @@
  */
 
 #include "Agent.h"
+#include "Counter.h"
+#include "TextBuffer.h"
 #include <string.h>
 
+#define AGENT_EXITED_BIT	( 1 << 0 )
+
 /***
  * Constructor
  */
 Agent::Agent() {
-	// NOP
-
+	xEvents = xEventGroupCreateStatic(&xEventsBuffer);
 }
 
 /***
@@ -22,6 +25,7 @@ Agent::Agent() {
  */
 Agent::~Agent() {
 	stop();
+	AgentRegistry::withdraw(this);
 }
 
 /***
@@ -35,6 +39,172 @@ void Agent::stop(){
 	}
 }
 
+/***
+ * Ask the task to finish at its next loop boundary
+ */
+void Agent::requestStop(){
+	xStopRequested = true;
+	if (xHandle != NULL){
+		xTaskNotifyGiveIndexed(xHandle, AGENT_STOP_NOTIFY_INDEX);
+		xTaskNotifyGiveIndexed(xHandle, AGENT_MAIL_NOTIFY_INDEX);
+	}
+}
+
+/***
+ * Ask the task to finish, callable from an interrupt
+ * @param pxHigherPriorityTaskWoken - set if a yield is needed
+ */
+void Agent::requestStopFromISR(BaseType_t *pxHigherPriorityTaskWoken){
+	xStopRequested = true;
+	if (xHandle != NULL){
+		vTaskNotifyGiveIndexedFromISR(xHandle, AGENT_STOP_NOTIFY_INDEX,
+				pxHigherPriorityTaskWoken);
+		vTaskNotifyGiveIndexedFromISR(xHandle, AGENT_MAIL_NOTIFY_INDEX,
+				pxHigherPriorityTaskWoken);
+	}
+}
+
+/***
+ * Has stop been requested
+ * @return
+ */
+bool Agent::isStopRequested(){
+	return xStopRequested;
+}
+
+/***
+ * Wait for the run loop to return after a stop request
+ * @param timeout - ticks to wait
+ * @return true if the task has finished
+ */
+bool Agent::join(TickType_t timeout){
+	EventBits_t bits = xEventGroupWaitBits(
+			xEvents,
+			AGENT_EXITED_BIT,
+			pdFALSE,
+			pdTRUE,
+			timeout);
+	return ((bits & AGENT_EXITED_BIT) != 0);
+}
+
+/***
+ * Delay that returns early if stop is requested
+ * @param ticks - maximum delay
+ * @return true if stop has been requested
+ */
+bool Agent::delayOrStop(TickType_t ticks){
+	if (!xStopRequested){
+		ulTaskNotifyTakeIndexed(AGENT_STOP_NOTIFY_INDEX, pdTRUE, ticks);
+	}
+	return xStopRequested;
+}
+
+void Agent::notifyMail(){
+	if (xHandle != NULL){
+		xTaskNotifyGiveIndexed(xHandle, AGENT_MAIL_NOTIFY_INDEX);
+	}
+}
+
+void Agent::notifyMailFromISR(BaseType_t *pxHigherPriorityTaskWoken){
+	if (xHandle != NULL){
+		vTaskNotifyGiveIndexedFromISR(xHandle, AGENT_MAIL_NOTIFY_INDEX,
+				pxHigherPriorityTaskWoken);
+	}
+}
+
+bool Agent::waitMail(TickType_t ticks){
+	if (!xStopRequested){
+		ulTaskNotifyTakeIndexed(AGENT_MAIL_NOTIFY_INDEX, pdTRUE, ticks);
+	}
+	return xStopRequested;
+}
+
+/***
+ * Has the run loop returned
+ * @return
+ */
+bool Agent::hasExited(){
+	return ((xEventGroupGetBits(xEvents) & AGENT_EXITED_BIT) != 0);
+}
+
+/***
+ * Stop the task cooperatively and start it again with the same
+ * name and priority
+ * @return false if the task is still running or could not start
+ */
+bool Agent::restart(){
+	char name[MAX_NAME_LEN];
+	if (xHandle != NULL){
+		requestStop();
+		if (!join(pdMS_TO_TICKS(AGENT_RESTART_JOIN_MS))){
+			if (!isKillSafe()){
+				return false;
+			}
+			stop();
+		}
+	}
+	strcpy(name, pName);
+	xRestarts++;
+	return start(name, xPriority);
+}
+
+bool Agent::isKillSafe(){
+	return false;
+}
+
+const char * Agent::getName(){
+	return pName;
+}
+
+UBaseType_t Agent::getPriority(){
+	return xPriority;
+}
+
+configSTACK_DEPTH_TYPE Agent::getStackSize(){
+	return getMaxStackSize();
+}
+
+const char * Agent::getKind(){
+	return pKind;
+}
+
+configSTACK_DEPTH_TYPE Agent::stackBudget(const char *kind, configSTACK_DEPTH_TYPE words){
+	pKind = kind;
+	return words;
+}
+
+uint32_t Agent::getLoops(){
+	return xLoops;
+}
+
+uint32_t Agent::getRestarts(){
+	return xRestarts;
+}
+
+uint8_t Agent::getSlot(){
+	return xSlot;
+}
+
+uint32_t Agent::getStallTimeoutMs(){
+	return 0;
+}
+
+/***
+ * Mark one iteration of the run loop
+ */
+void Agent::heartbeat(){
+	xLoops = xLoops + 1;
+}
+
+/***
+ * Called on the task once run has returned
+ */
+void Agent::exited(){
+	xExitHighWater = uxTaskGetStackHighWaterMark(NULL);
+	xHandle = NULL;
+	xEventGroupSetBits(xEvents, AGENT_EXITED_BIT);
+}
+
 
 /***
 * Get high water for stack
@@ -44,7 +214,7 @@ unsigned int Agent::getStakHighWater(){
 	if (xHandle != NULL)
 		return uxTaskGetStackHighWaterMark(xHandle);
 	else
-		return 0;
+		return xExitHighWater;
 }
 
 
@@ -71,6 +241,20 @@ bool Agent::start(const char *name, UBaseType_t priority){
 	} else {
 		strcpy(pName, name);
 	}
+	xPriority = priority;
+	xStopRequested = false;
+	xEventGroupClearBits(xEvents, AGENT_EXITED_BIT);
+	xSlot = AgentRegistry::enrol(this);
+	if (xSlot == AGENT_REGISTRY_NONE){
+		//Would run without supervision, task number or telemetry
+		char msg[64];
+		TextBuffer text(msg, sizeof(msg));
+		text.add("Agent ").add(pName)
+			.add(" not started, registry full at ").addUnsigned(AGENT_REGISTRY_MAX)
+			.add("\n\r");
+		Counter::getInstance()->print(text.c_str());
+		return false;
+	}
 	res = xTaskCreate(
 			Agent::vTask,       /* Function that implements the task. */
 		pName,   /* Text name for the task. */
@@ -79,6 +263,10 @@ bool Agent::start(const char *name, UBaseType_t priority){
 		priority,/* Priority at which the task is created. */
 		&xHandle
 	);
+	if (res == pdPASS){
+		//Task number identifies the agent in trace and stats
+		vTaskSetTaskNumber(xHandle, xSlot + 1);
+	}
 	return (res == pdPASS);
 }
 
@@ -92,5 +280,7 @@ bool Agent::start(const char *name, UBaseType_t priority){
 	 Agent *task = (Agent *) pvParameters;
 	 if (task != NULL){
 		 task->run();
+		 task->exited();
 	 }
+	 vTaskDelete(NULL);
  }
@@ -13,8 +13,21 @@
 
 #define MAX_NAME_LEN 20
 
+//Task notification index used to wake an agent when stop is requested
+#define AGENT_STOP_NOTIFY_INDEX 1
+//Task notification index used to wake an agent when mail is posted
+#define AGENT_MAIL_NOTIFY_INDEX 2
+//Time restart waits for the run loop to return before giving up
+#define AGENT_RESTART_JOIN_MS 500
+
 #include "FreeRTOS.h"
 #include "task.h"
+#include "event_groups.h"
+#include "AgentRegistry.h"
+#include "StackBudgets.h"
+
+//Stack for a kind of Agent from StackBudgets.h, for use in getMaxStackSize
+#define STACK_BUDGET(kind)	stackBudget(#kind, StackBudgets::kind)
 
 
 class Agent {
@@ -43,10 +56,105 @@ public:
 	 */
 	virtual void stop();
 
+	/***
+	 * Ask the task to finish at its next loop boundary
+	 */
+	virtual void requestStop();
+
+	/***
+	 * Ask the task to finish, callable from an interrupt
+	 * @param pxHigherPriorityTaskWoken - set if a yield is needed
+	 */
+	virtual void requestStopFromISR(BaseType_t *pxHigherPriorityTaskWoken);
+
+	/***
+	 * Has stop been requested
+	 * @return
+	 */
+	bool isStopRequested();
+
+	/***
+	 * Wait for the run loop to return after a stop request
+	 * @param timeout - ticks to wait
+	 * @return true if the task has finished
+	 */
+	bool join(TickType_t timeout = portMAX_DELAY);
+
+	/***
+	 * Has the run loop returned
+	 * @return
+	 */
+	bool hasExited();
+
+	/***
+	 * Ask the task to stop, wait up to AGENT_RESTART_JOIN_MS for the run
+	 * loop to return, then start it again with the same name and
+	 * priority. A task that does not return in time is only deleted if
+	 * isKillSafe, otherwise it is left to finish and restart fails.
+	 * @return false if the task is still running or could not start
+	 */
+	virtual bool restart();
+
+	/***
+	 * Can the task be deleted at any point in its run loop. Deleting a
+	 * task leaks its heap and any lock it holds, so only agents that
+	 * hold neither across a loop should return true.
+	 * @return default false
+	 */
+	virtual bool isKillSafe();
 
 	/***
-	 * Get high water for stack
-	 * @return close to zero means overflow risk
+	 * Name given at start
+	 * @return
+	 */
+	const char * getName();
+
+	/***
+	 * Priority given at start
+	 * @return
+	 */
+	UBaseType_t getPriority();
+
+	/***
+	 * Stack size allocated to the task
+	 * @return - words
+	 */
+	configSTACK_DEPTH_TYPE getStackSize();
+
+	/***
+	 * Kind of Agent its stack budget is kept under
+	 * @return NULL if getMaxStackSize does not use STACK_BUDGET
+	 */
+	const char * getKind();
+
+	/***
+	 * Count of run loop iterations, see heartbeat
+	 * @return
+	 */
+	uint32_t getLoops();
+
+	/***
+	 * Number of times restart has been called
+	 * @return
+	 */
+	uint32_t getRestarts();
+
+	/***
+	 * Slot in the AgentRegistry
+	 * @return
+	 */
+	uint8_t getSlot();
+
+	/***
+	 * Time without a heartbeat before the agent is treated as stalled
+	 * @return ms, 0 disables stall detection
+	 */
+	virtual uint32_t getStallTimeoutMs();
+
+
+	/***
+	 * Get high water for stack, kept from the last run once exited
+	 * @return close to zero means overflow risk, 0 if never run
 	 */
 	virtual unsigned int getStakHighWater();
 
@@ -56,6 +164,24 @@ public:
 	 */
 	virtual TaskHandle_t getTask();
 
+	/***
+	 * Wake the agent if it is waiting for mail, see Mailbox
+	 */
+	void notifyMail();
+
+	/***
+	 * Wake the agent if it is waiting for mail, callable from an interrupt
+	 * @param pxHigherPriorityTaskWoken - set if a yield is needed
+	 */
+	void notifyMailFromISR(BaseType_t *pxHigherPriorityTaskWoken);
+
+	/***
+	 * Wait for mail to be posted. Call from the agent's own task.
+	 * @param ticks - maximum wait
+	 * @return true if stop has been requested
+	 */
+	bool waitMail(TickType_t ticks);
+
 protected:
 	/***
 	 * Start the task via static function
@@ -74,11 +200,47 @@ protected:
 	 */
 	virtual configSTACK_DEPTH_TYPE getMaxStackSize()=0;
 
+	/***
+	 * Delay that returns early if stop is requested
+	 * @param ticks - maximum delay
+	 * @return true if stop has been requested
+	 */
+	bool delayOrStop(TickType_t ticks);
+
+	/***
+	 * Mark one iteration of the run loop
+	 */
+	void heartbeat();
+
+	/***
+	 * Note the kind of Agent and return its budget, see STACK_BUDGET
+	 * @param kind
+	 * @param words
+	 * @return words
+	 */
+	configSTACK_DEPTH_TYPE stackBudget(const char *kind, configSTACK_DEPTH_TYPE words);
+
 	//The task
 	TaskHandle_t xHandle = NULL;
 
 	char pName[MAX_NAME_LEN];
 
+private:
+	/***
+	 * Called on the task once run has returned
+	 */
+	void exited();
+
+	volatile bool xStopRequested = false;
+	volatile uint32_t xLoops = 0;
+	uint32_t xRestarts = 0;
+	UBaseType_t xPriority = tskIDLE_PRIORITY;
+	uint8_t xSlot = AGENT_REGISTRY_NONE;
+	const char *pKind = NULL;
+	unsigned int xExitHighWater = 0;
+
+	EventGroupHandle_t xEvents = NULL;
+	StaticEventGroup_t xEventsBuffer;
 
 };
 
@@ -0,0 +1,65 @@
+/*
+ * AgentRegistry.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "AgentRegistry.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+Agent *AgentRegistry::pAgents[AGENT_REGISTRY_MAX] = {NULL};
+uint8_t AgentRegistry::xSlots = 0;
+
+
+uint8_t AgentRegistry::enrol(Agent *agent){
+	uint8_t slot = AGENT_REGISTRY_NONE;
+
+	taskENTER_CRITICAL();
+	for (uint8_t i = 0; i < xSlots; i++){
+		if (pAgents[i] == agent){
+			slot = i;
+			break;
+		}
+	}
+	if (slot == AGENT_REGISTRY_NONE){
+		//Reuse a withdrawn slot before growing
+		for (uint8_t i = 0; i < xSlots; i++){
+			if (pAgents[i] == NULL){
+				slot = i;
+				break;
+			}
+		}
+		if ((slot == AGENT_REGISTRY_NONE) && (xSlots < AGENT_REGISTRY_MAX)){
+			slot = xSlots++;
+		}
+		if (slot != AGENT_REGISTRY_NONE){
+			pAgents[slot] = agent;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return slot;
+}
+
+void AgentRegistry::withdraw(Agent *agent){
+	taskENTER_CRITICAL();
+	for (uint8_t i = 0; i < xSlots; i++){
+		if (pAgents[i] == agent){
+			pAgents[i] = NULL;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+
+Agent * AgentRegistry::getAgent(uint8_t slot){
+	if (slot < xSlots){
+		return pAgents[slot];
+	}
+	return NULL;
+}
+
+uint8_t AgentRegistry::getSlots(){
+	return xSlots;
+}
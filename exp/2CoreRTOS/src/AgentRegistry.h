@@ -0,0 +1,53 @@
+/*
+ * AgentRegistry.h
+ *
+ * Fixed table of every Agent that has been started
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_AGENTREGISTRY_H_
+#define EXP_2CORERTOS_SRC_AGENTREGISTRY_H_
+
+#include <stdint.h>
+
+#define AGENT_REGISTRY_MAX 	16		//Keep TST_MAX_AGENTS and TRACE_MAX_TASKS in step
+#define AGENT_REGISTRY_NONE	0xFF
+
+class Agent;
+
+class AgentRegistry {
+public:
+	/***
+	 * Add agent to the registry, no effect if already present
+	 * @param agent
+	 * @return slot number or AGENT_REGISTRY_NONE if full
+	 */
+	static uint8_t enrol(Agent *agent);
+
+	/***
+	 * Remove agent from the registry
+	 * @param agent
+	 */
+	static void withdraw(Agent *agent);
+
+	/***
+	 * Get agent in slot
+	 * @param slot
+	 * @return NULL if slot is empty
+	 */
+	static Agent * getAgent(uint8_t slot);
+
+	/***
+	 * Number of slots ever used, iterate slots below this
+	 * @return
+	 */
+	static uint8_t getSlots();
+
+private:
+	static Agent *pAgents[AGENT_REGISTRY_MAX];
+	static uint8_t xSlots;
+};
+
+#endif /* EXP_2CORERTOS_SRC_AGENTREGISTRY_H_ */
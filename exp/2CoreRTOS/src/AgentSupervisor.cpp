@@ -0,0 +1,203 @@
+/*
+ * AgentSupervisor.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "AgentSupervisor.h"
+#include "TextBuffer.h"
+#include <cstring>
+
+static_assert(TST_MAX_AGENTS >= AGENT_REGISTRY_MAX, "TST_MAX_AGENTS must cover every registry slot");
+
+AgentSupervisor::AgentSupervisor() {
+	for (uint8_t i = 0; i < AGENT_REGISTRY_MAX; i++){
+		xLastLoops[i] = 0;
+		xStallMs[i] = 0;
+		xStackLevel[i] = 0;
+		xStackRestarts[i] = 0;
+		xRestartPending[i] = false;
+#if configGENERATE_RUN_TIME_STATS
+		xLastRunTime[i] = 0;
+#endif
+	}
+}
+
+AgentSupervisor::~AgentSupervisor() {
+	stop();
+}
+
+/***
+ * Task main run loop
+ */
+void AgentSupervisor::run(){
+	uint64_t last = time_us_64();
+	while (!delayOrStop(pdMS_TO_TICKS(SUPERVISOR_PERIOD_MS))){
+		heartbeat();
+		uint64_t now = time_us_64();
+		uint8_t slots = AgentRegistry::getSlots();
+		if (slots > TST_MAX_AGENTS){
+			slots = TST_MAX_AGENTS;
+		}
+		for (uint8_t i = 0; i < slots; i++){
+			sample(i, now - last);
+		}
+		TST_V.agentCount = slots;
+		last = now;
+
+		if (slots != xNamed){
+			publishNames();
+			xNamed = slots;
+		}
+	}
+}
+
+void AgentSupervisor::sample(uint8_t slot, uint64_t elapsedUs){
+	TST_AgentStat *stat = &TST_V.agents[slot];
+	Agent *agent = AgentRegistry::getAgent(slot);
+
+	if (agent == NULL){
+		memset(stat, 0, sizeof(TST_AgentStat));
+		stat->state = 0xFF;
+		return;
+	}
+
+	TaskHandle_t task = agent->getTask();
+	uint32_t loops = agent->getLoops();
+	uint32_t elapsedMs = (uint32_t)(elapsedUs / 1000);
+
+	stat->flags = 0;
+	stat->restarts = agent->getRestarts();
+	stat->loopRate = (uint16_t)(
+			((uint64_t)(loops - xLastLoops[slot]) * 1000000) / elapsedUs);
+
+	if (task == NULL){
+		stat->state = 0xFF;
+		stat->stackFree = 0;
+		stat->stackSize = agent->getStackSize();
+		stat->stackUsed = 0;
+		stat->cpu = 0;
+	} else {
+		stat->state = eTaskGetState(task);
+		checkStack(slot, agent, stat);
+#if configGENERATE_RUN_TIME_STATS
+		configRUN_TIME_COUNTER_TYPE runTime = ulTaskGetRunTimeCounter(task);
+		stat->cpu = (uint8_t)(((uint64_t)(runTime - xLastRunTime[slot]) * 200) / elapsedUs);
+		xLastRunTime[slot] = runTime;
+#else
+		stat->cpu = 0;
+#endif
+	}
+
+	//Exited without being asked to, or finished after a stall restart
+	if (agent->hasExited()){
+		stat->flags |= SUPERVISOR_FLAG_EXITED;
+		if (!agent->isStopRequested() || xRestartPending[slot]){
+			xRestartPending[slot] = false;
+			agent->restart();
+		}
+	}
+
+	//No heartbeat within the agent's timeout
+	uint32_t timeout = agent->getStallTimeoutMs();
+	if ((timeout > 0) && (task != NULL) && (!agent->isStopRequested())){
+		if (loops == xLastLoops[slot]){
+			xStallMs[slot] += elapsedMs;
+			if (xStallMs[slot] >= timeout){
+				stat->flags |= SUPERVISOR_FLAG_STALLED;
+				xStallMs[slot] = 0;
+				//Still busy, restart once its loop sees the stop
+				xRestartPending[slot] = !agent->restart();
+			}
+		} else {
+			xStallMs[slot] = 0;
+		}
+	}
+
+	xLastLoops[slot] = agent->getLoops();
+}
+
+void AgentSupervisor::checkStack(uint8_t slot, Agent *agent, TST_AgentStat *stat){
+	uint32_t size = agent->getStackSize();
+	uint32_t unused = agent->getStakHighWater();
+	uint8_t used = (size > 0) ? (uint8_t)(((size - unused) * 100) / size) : 0;
+
+	stat->stackFree = unused;
+	stat->stackSize = size;
+	stat->stackUsed = used;
+
+	//A restarted agent has a fresh stack
+	if (agent->getRestarts() != xStackRestarts[slot]){
+		xStackRestarts[slot] = agent->getRestarts();
+		xStackLevel[slot] = 0;
+	}
+
+	uint8_t level = 0;
+	if (used >= SUPERVISOR_STACK_CRIT){
+		level = SUPERVISOR_STACK_CRIT;
+	} else if (used >= SUPERVISOR_STACK_WARN){
+		level = SUPERVISOR_STACK_WARN;
+	}
+	if (level > 0){
+		stat->flags |= SUPERVISOR_FLAG_STACK;
+	}
+	if (level <= xStackLevel[slot]){
+		return;
+	}
+	xStackLevel[slot] = level;
+
+	char msg[64];
+	TextBuffer text(msg, sizeof(msg));
+	text.add("Stack ").add(agent->getName())
+		.add(' ').addUnsigned(used).add("% ")
+		.addUnsigned(size - unused).add('/').addUnsigned(size).add(" words");
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+}
+
+void AgentSupervisor::reportStacks(Counter *counter){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+	for (uint8_t i = 0; i < AgentRegistry::getSlots(); i++){
+		Agent *agent = AgentRegistry::getAgent(i);
+		if (agent == NULL){
+			continue;
+		}
+		const char *kind = agent->getKind();
+		uint32_t size = agent->getStackSize();
+		text.clear();
+		text.add("STACK kind=").add((kind != NULL) ? kind : "-")
+			.add(" used=").addUnsigned(size - agent->getStakHighWater())
+			.add(" size=").addUnsigned(size)
+			.add(" agent=").add(agent->getName()).add("\n\r");
+		counter->print(text.c_str());
+	}
+}
+
+void AgentSupervisor::publishNames(){
+	char msg[128];
+	TextBuffer text(msg, sizeof(msg));
+	text.add("Agents:");
+	for (uint8_t i = 0; i < AgentRegistry::getSlots(); i++){
+		Agent *agent = AgentRegistry::getAgent(i);
+		if (agent == NULL){
+			continue;
+		}
+		//Flush before a name would be truncated
+		if ((text.length() + MAX_NAME_LEN + 6) >= sizeof(msg)){
+			tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+			text.clear();
+			text.add("Agents:");
+		}
+		text.add(' ').addUnsigned(i).add('=').add(agent->getName());
+	}
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE AgentSupervisor::getMaxStackSize(){
+	return STACK_BUDGET(AgentSupervisor);
+}
@@ -0,0 +1,93 @@
+/*
+ * AgentSupervisor.h
+ *
+ * Periodically samples every registered Agent, publishes the table
+ * to TST and restarts agents that have exited or stalled. A stalled
+ * agent is asked to stop and is restarted when its run loop returns,
+ * it is only deleted in place if it is kill safe.
+ *
+ * Stack use is checked against the allocation each sample. Crossing
+ * SUPERVISOR_STACK_WARN or SUPERVISOR_STACK_CRIT sends a monitor event
+ * once per level, before the overflow check could trap it.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_AGENTSUPERVISOR_H_
+#define EXP_2CORERTOS_SRC_AGENTSUPERVISOR_H_
+
+#include "Agent.h"
+#include "AgentRegistry.h"
+#include "Counter.h"
+#include "pico/stdlib.h"
+extern "C"{
+#include "tst_variables.h"
+}
+
+#define SUPERVISOR_PERIOD_MS	1000
+
+#define SUPERVISOR_FLAG_EXITED	0x01
+#define SUPERVISOR_FLAG_STALLED	0x02
+#define SUPERVISOR_FLAG_STACK	0x04
+
+#define SUPERVISOR_STACK_WARN	75		//% of stack used
+#define SUPERVISOR_STACK_CRIT	90
+
+class AgentSupervisor : public Agent {
+public:
+	AgentSupervisor();
+	virtual ~AgentSupervisor();
+
+	/***
+	 * Print a machine readable STACK line per Agent for
+	 * tools/stack_budget.py
+	 * @param counter - used for output
+	 */
+	void reportStacks(Counter *counter);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Sample one agent into its TST slot, restart it if needed
+	 * @param slot
+	 * @param elapsedUs - time since the last sample
+	 */
+	void sample(uint8_t slot, uint64_t elapsedUs);
+
+	/***
+	 * Send slot to name mapping to the TST monitor
+	 */
+	void publishNames();
+
+	/***
+	 * Publish stack use and send an event when it crosses a level
+	 * @param slot
+	 * @param agent - running
+	 * @param stat
+	 */
+	void checkStack(uint8_t slot, Agent *agent, TST_AgentStat *stat);
+
+	uint32_t xLastLoops[AGENT_REGISTRY_MAX];
+	uint32_t xStallMs[AGENT_REGISTRY_MAX];
+	uint8_t xStackLevel[AGENT_REGISTRY_MAX];	//Highest level reported
+	uint32_t xStackRestarts[AGENT_REGISTRY_MAX];
+	bool xRestartPending[AGENT_REGISTRY_MAX];	//Stop requested by a stall
+#if configGENERATE_RUN_TIME_STATS
+	configRUN_TIME_COUNTER_TYPE xLastRunTime[AGENT_REGISTRY_MAX];
+#endif
+	uint8_t xNamed = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_AGENTSUPERVISOR_H_ */
@@ -0,0 +1,199 @@
+/*
+ * BenchHarness.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "BenchHarness.h"
+#include "TextBuffer.h"
+
+//Name of the build variant, set by variants.cmake
+#ifndef PICALC_VARIANT
+#define PICALC_VARIANT "default"
+#endif
+
+BenchHarness::BenchHarness(Counter *counter) {
+	pCounter = counter;
+	xGate = xEventGroupCreateStatic(&xGateBuffer);
+	for (uint8_t i = 0; i < BENCH_MAX_TRIALS; i++){
+		xRate[i] = 0;
+	}
+}
+
+BenchHarness::~BenchHarness() {
+	// NOP
+}
+
+bool BenchHarness::addWorker(Worker *worker){
+	if (xWorkers >= MAX_ID){
+		return false;
+	}
+	EventBits_t parked = 1 << (1 + xWorkers);
+	worker->setGate(xGate, BENCH_RUN_BIT, parked);
+	xParkedBits |= parked;
+	xWorkers++;
+	return true;
+}
+
+void BenchHarness::run(uint8_t trials, uint32_t trialMs, uint32_t warmupMs){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	xTrials = (trials > BENCH_MAX_TRIALS) ? BENCH_MAX_TRIALS : trials;
+	xTrialMs = trialMs;
+	xWarmupMs = warmupMs;
+
+	park();
+	if (warmupMs > 0){
+		pCounter->print("Warm up\n\r");
+		release(warmupMs);
+		park();
+	}
+
+	for (uint8_t t = 0; t < xTrials; t++){
+		pCounter->start();
+		release(trialMs);
+		pCounter->stop();
+
+		Counter::Record rec;
+		pCounter->getRecord(rec);
+		uint32_t total = rec.xCounts.total();
+		xRate[t] = (rec.xSampleMs > 0) ?
+				((uint64_t)total * 1000000ULL) / rec.xSampleMs : 0;
+
+		text.clear();
+		text.add("TRIAL n=").addUnsigned(t)
+			.add(" ms=").addUnsigned(rec.xSampleMs)
+			.add(" total=").addUnsigned(total)
+			.add(" persec=").addFixed(xRate[t], 3).add("\n\r");
+		pCounter->print(text.c_str());
+
+		park();
+	}
+}
+
+void BenchHarness::release(uint32_t ms){
+	xEventGroupSetBits(xGate, BENCH_RUN_BIT);
+	vTaskDelay(pdMS_TO_TICKS(ms));
+	xEventGroupClearBits(xGate, BENCH_RUN_BIT);
+}
+
+bool BenchHarness::park(){
+	EventBits_t bits = xEventGroupWaitBits(xGate, xParkedBits, pdFALSE, pdTRUE,
+			pdMS_TO_TICKS(BENCH_PARK_MS));
+	if ((bits & xParkedBits) != xParkedBits){
+		xLateParks++;
+		return false;
+	}
+	return true;
+}
+
+void BenchHarness::report(){
+	char line[120];
+	TextBuffer text(line, sizeof(line));
+
+	if (xTrials == 0){
+		return;
+	}
+
+	uint64_t sum = 0;
+	uint64_t min = UINT64_MAX;
+	uint64_t max = 0;
+	for (uint8_t t = 0; t < xTrials; t++){
+		sum += xRate[t];
+		if (xRate[t] < min){
+			min = xRate[t];
+		}
+		if (xRate[t] > max){
+			max = xRate[t];
+		}
+	}
+	uint64_t mean = sum / xTrials;
+
+	//Sample standard deviation, rates are x1000 so variance is x10^6
+	uint64_t sumSq = 0;
+	for (uint8_t t = 0; t < xTrials; t++){
+		int64_t d = (int64_t)xRate[t] - (int64_t)mean;
+		sumSq += (uint64_t)(d * d);
+	}
+	uint64_t sd = (xTrials > 1) ? isqrt(sumSq / (xTrials - 1)) : 0;
+	//t and sqrt(n) are both x1000 so the scales cancel
+	uint64_t ci = (xTrials > 1) ?
+			(sd * tValue(xTrials)) / isqrt((uint64_t)xTrials * 1000000) : 0;
+
+	text.add("Trials ").addUnsigned(xTrials)
+		.add(" of ").addUnsigned(xTrialMs).add(" ms after ")
+		.addUnsigned(xWarmupMs).add(" ms warm up\n\r");
+	pCounter->print(text.c_str());
+
+	text.clear();
+	text.add("Per sec mean ").addFixed(mean, 3)
+		.add(" sd ").addFixed(sd, 3)
+		.add(" min ").addFixed(min, 3)
+		.add(" max ").addFixed(max, 3).add("\n\r");
+	pCounter->print(text.c_str());
+
+	text.clear();
+	text.add("95% CI ").addFixed(mean - ((ci < mean) ? ci : mean), 3)
+		.add(" to ").addFixed(mean + ci, 3);
+	if (mean > 0){
+		text.add(" (+/-").addFixed((ci * 100000) / mean, 3).add("%)");
+	}
+	text.add("\n\r");
+	pCounter->print(text.c_str());
+
+	if (xLateParks > 0){
+		text.clear();
+		text.add("Workers late to park ").addUnsigned(xLateParks).add(" times\n\r");
+		pCounter->print(text.c_str());
+	}
+
+	//Machine readable summary
+	text.clear();
+	text.add("BENCH variant=").add(PICALC_VARIANT)
+		.add(" trials=").addUnsigned(xTrials)
+		.add(" trial_ms=").addUnsigned(xTrialMs)
+		.add(" warmup_ms=").addUnsigned(xWarmupMs)
+		.add(" mean=").addFixed(mean, 3)
+		.add(" sd=").addFixed(sd, 3)
+		.add(" min=").addFixed(min, 3)
+		.add(" max=").addFixed(max, 3)
+		.add(" ci95=").addFixed(ci, 3).add("\n\r");
+	pCounter->print(text.c_str());
+}
+
+uint32_t BenchHarness::tValue(uint8_t n){
+	//Indexed by degrees of freedom, 1 to 30
+	static const uint16_t table[] = {
+		12706, 4303, 3182, 2776, 2571, 2447, 2365, 2306, 2262, 2228,
+		2201, 2179, 2160, 2145, 2131, 2120, 2110, 2101, 2093, 2086,
+		2080, 2074, 2069, 2064, 2060, 2056, 2052, 2048, 2045, 2042
+	};
+	uint8_t df = n - 1;
+	if (df < 1){
+		return 0;
+	}
+	if (df > 30){
+		return 1960;
+	}
+	return table[df - 1];
+}
+
+uint64_t BenchHarness::isqrt(uint64_t x){
+	uint64_t res = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+	while (bit > x){
+		bit >>= 2;
+	}
+	while (bit != 0){
+		if (x >= res + bit){
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+	return res;
+}
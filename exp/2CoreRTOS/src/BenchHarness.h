@@ -0,0 +1,101 @@
+/*
+ * BenchHarness.h
+ *
+ * Runs the Workers through a warm up and then a number of timed
+ * trials. All Workers are released and halted together through an
+ * event group, and each trial starts only once every Worker is parked.
+ * Reports mean, standard deviation, range and a 95% confidence
+ * interval of the per second rate, then a BENCH line for tools.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_BENCHHARNESS_H_
+#define EXP_2CORERTOS_SRC_BENCHHARNESS_H_
+
+#include "Worker.h"
+#include "Counter.h"
+#include "event_groups.h"
+
+#ifndef BENCH_WARMUP_MS
+#define BENCH_WARMUP_MS		5000
+#endif
+#ifndef BENCH_TRIALS
+#define BENCH_TRIALS		10
+#endif
+#ifndef BENCH_TRIAL_MS
+#define BENCH_TRIAL_MS		10000
+#endif
+
+#define BENCH_MAX_TRIALS	32
+#define BENCH_PARK_MS		15000	//Longest a Worker may take to finish a job
+#define BENCH_RUN_BIT		(1 << 0)
+
+class BenchHarness {
+public:
+	BenchHarness(Counter *counter);
+	virtual ~BenchHarness();
+
+	/***
+	 * Gate a worker, call before the worker is started
+	 * @param worker
+	 * @return false if MAX_ID workers are already added
+	 */
+	bool addWorker(Worker *worker);
+
+	/***
+	 * Warm up then run the trials, blocks the calling task
+	 * @param trials - up to BENCH_MAX_TRIALS
+	 * @param trialMs
+	 * @param warmupMs
+	 */
+	void run(uint8_t trials = BENCH_TRIALS, uint32_t trialMs = BENCH_TRIAL_MS,
+			uint32_t warmupMs = BENCH_WARMUP_MS);
+
+	/***
+	 * Print the statistics and the machine readable summary
+	 */
+	void report();
+
+private:
+	/***
+	 * Let the workers run for a time
+	 * @param ms
+	 */
+	void release(uint32_t ms);
+
+	/***
+	 * Wait until every worker is parked at the gate
+	 * @return false if one did not park in time
+	 */
+	bool park();
+
+	/***
+	 * Two sided 95% Student t value for a sample
+	 * @param n - sample size
+	 * @return t x 1000
+	 */
+	static uint32_t tValue(uint8_t n);
+
+	/***
+	 * Integer square root
+	 * @param x
+	 * @return floor of the root
+	 */
+	static uint64_t isqrt(uint64_t x);
+
+	Counter *pCounter;
+	EventGroupHandle_t xGate = NULL;
+	StaticEventGroup_t xGateBuffer;
+	EventBits_t xParkedBits = 0;
+	uint8_t xWorkers = 0;
+
+	uint8_t xTrials = 0;
+	uint32_t xTrialMs = 0;
+	uint32_t xWarmupMs = 0;
+	uint32_t xLateParks = 0;
+	uint64_t xRate[BENCH_MAX_TRIALS];	//Iterations per sec x1000
+};
+
+#endif /* EXP_2CORERTOS_SRC_BENCHHARNESS_H_ */
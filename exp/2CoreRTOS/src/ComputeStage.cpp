@@ -0,0 +1,75 @@
+/*
+ * ComputeStage.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "ComputeStage.h"
+#include <pi_spigot/pi_spigot.h>
+#include <vector>
+
+ComputeStage::ComputeStage(uint8_t id, PipelineLink *out) {
+	xId = id;
+	pOut = out;
+}
+
+ComputeStage::~ComputeStage() {
+	stop();
+}
+
+/***
+ * Task main run loop
+ */
+void ComputeStage::run(){
+	place();
+	ResultBlock block;
+	for (;;){
+		heartbeat();
+		uint64_t start = time_us_64();
+		compute(block);
+		block.xSeq = xSeq++;
+		block.xWorker = xId;
+		block.xCore = get_core_num();
+		block.xComputeUs = (uint32_t)(time_us_64() - start);
+		account(start);
+
+		pOut->push(block);
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE ComputeStage::getMaxStackSize(){
+	return STACK_BUDGET(ComputeStage);
+}
+
+void ComputeStage::compute(ResultBlock &block){
+	using pi_spigot_type = math::constants::pi_spigot<1000, 9>;
+
+	using input_container_type  = std::vector<std::uint32_t>;
+	using output_container_type = std::vector<std::uint8_t>;
+
+	input_container_type  pi_in(pi_spigot_type::get_input_static_size());
+	output_container_type pi_out(pi_spigot_type::get_output_static_size());
+
+	pi_spigot_type ps;
+	ps.calculate(pi_in.begin(), pi_out.begin());
+
+	//Fletcher style checksum over all digits
+	uint32_t a = 0;
+	uint32_t b = 0;
+	for (size_t i = 0; i < pi_out.size(); i++){
+		a = (a + pi_out[i]) % 65535;
+		b = (b + a) % 65535;
+	}
+	block.xChecksum = (b << 16) | a;
+
+	block.xPrefix = 0;
+	for (size_t i = 0; (i < 8) && (i < pi_out.size()); i++){
+		block.xPrefix = block.xPrefix * 10 + pi_out[i];
+	}
+	block.xValid = false;
+}
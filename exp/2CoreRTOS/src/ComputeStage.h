@@ -0,0 +1,44 @@
+/*
+ * ComputeStage.h
+ *
+ * Pipeline stage that calculates PI and produces result blocks
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_COMPUTESTAGE_H_
+#define EXP_2CORERTOS_SRC_COMPUTESTAGE_H_
+
+#include "PipelineStage.h"
+
+class ComputeStage : public PipelineStage {
+public:
+	ComputeStage(uint8_t id, PipelineLink *out);
+	virtual ~ComputeStage();
+
+	/***
+	 * Calculate PI and summarise the digits into block
+	 * @param block
+	 */
+	static void compute(ResultBlock &block);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	uint8_t xId;
+	PipelineLink *pOut;
+	uint32_t xSeq = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_COMPUTESTAGE_H_ */
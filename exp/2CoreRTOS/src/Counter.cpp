@@ -6,13 +6,41 @@
  */
 
 #include "Counter.h"
+#include "Reporter.h"
+#include "TextBuffer.h"
+#include "ScopeTimer.h"
 #include <cstdio>
 
+//Name of the build variant, set by variants.cmake
+#ifndef PICALC_VARIANT
+#define PICALC_VARIANT "default"
+#endif
+
 Counter *Counter::pSingleton = NULL;
 
-Counter::Counter() {
-	// TODO Auto-generated constructor stub
+static const char * const idJobNames[MAX_ID] = {
+	"job.id0", "job.id1", "job.id2", "job.id3"
+};
+static const char * const coreJobNames[MAX_CORES] = {
+	"job.core0", "job.core1"
+};
+static const char * const idCountNames[MAX_ID] = {
+	"count.id0", "count.id1", "count.id2", "count.id3"
+};
+static const char * const coreCountNames[MAX_CORES] = {
+	"count.core0", "count.core1"
+};
 
+Counter::Counter() {
+	MetricRegistry *registry = MetricRegistry::getInstance();
+	for (int i = 0; i < MAX_ID; i++){
+		registry->counter(idCountNames[i], &xCounts, Counts::idIndex(i));
+		pIdJobs[i] = registry->histogram(idJobNames[i]);
+	}
+	for (int i = 0; i < MAX_CORES; i++){
+		registry->counter(coreCountNames[i], &xCounts, Counts::coreIndex(i));
+		pCoreJobs[i] = registry->histogram(coreJobNames[i]);
+	}
 }
 
 Counter::~Counter() {
@@ -36,77 +64,188 @@ void Counter::setUart(uart_inst_t *uart){
 
 void Counter::start(){
 	print( "Start\n\r");
-	xStartTime =  to_ms_since_boot(get_absolute_time());
+	//Counts are never cleared, the window is the difference from here
+	xCounts.snapshot(xStart);
 	for (int i = 0; i < MAX_ID; i++){
-		xCounts[i] = 0;
+		if (pIdJobs[i] != NULL){
+			pIdJobs[i]->reset();
+		}
 	}
 	for (int i = 0; i < MAX_CORES; i++){
-		xCoreCounts[i] = 0;
+		if (pCoreJobs[i] != NULL){
+			pCoreJobs[i]->reset();
+		}
 	}
+	xStartTime =  to_ms_since_boot(get_absolute_time());
+	xStopTime = 0;
 }
 
-void Counter::inc(uint8_t id){
-	if (id < MAX_ID){
-		if (xStopTime == 0){
-			xCounts[id]++;
-			xCoreCounts[get_core_num()]++;
-		}
+/***
+ * Close the sample window, counts are frozen from here.
+ * Safe to call from an interrupt.
+ */
+void Counter::stop(){
+	if (xStopTime == 0){
+		xCounts.snapshot(xStop);
+		xStopTime =  to_ms_since_boot(get_absolute_time());
 	}
+}
 
+void Counter::inc(uint8_t id){
+	SCOPE_TIMER("Counter::inc");
+	xCounts.inc(id);
 }
 
 void Counter::incCore(uint8_t id, uint8_t  core){
-	if (id < MAX_ID){
-		if (xStopTime == 0){
-			xCounts[id]++;
-		}
+	xCounts.incCore(id, core);
+}
+
+void Counter::recordJob(uint8_t id, uint32_t ns){
+	if ((id >= MAX_ID) || (xStopTime != 0)){
+		return;
 	}
-	if (core < MAX_CORES){
-		if (xStopTime == 0){
-			xCoreCounts[core]++;
-		}
+	if (pIdJobs[id] != NULL){
+		pIdJobs[id]->record(ns);
+	}
+
+	//Core histograms are shared by the tasks on a core
+	uint32_t irq = save_and_disable_interrupts();
+	uint8_t core = get_core_num();
+	if ((core < MAX_CORES) && (pCoreJobs[core] != NULL)){
+		pCoreJobs[core]->record(ns);
 	}
+	restore_interrupts(irq);
+}
+
+const Histogram *Counter::getIdJobs(uint8_t id){
+	return (id < MAX_ID) ? pIdJobs[id] : NULL;
+}
+
+const Histogram *Counter::getCoreJobs(uint8_t core){
+	return (core < MAX_CORES) ? pCoreJobs[core] : NULL;
+}
+
+void Counter::printJobs(const char *label, const Histogram *hist){
+	if (hist == NULL){
+		return;
+	}
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+	uint32_t ns[5] = {
+		hist->getMin(),
+		hist->percentile(500),
+		hist->percentile(900),
+		hist->percentile(990),
+		hist->getMax()
+	};
+	text.add(label);
+	for (int i = 0; i < 5; i++){
+		//ns to us with one decimal place
+		text.add('\t').addFixed(ns[i] / 100, 1);
+	}
+	text.add("\n\r");
+	print(text.c_str());
+}
+
+void Counter::window(Counts::Snapshot &snap){
+	if (xStopTime == 0){
+		xCounts.snapshot(snap);
+	} else {
+		snap = xStop;
+	}
+	snap.since(xStart);
+}
+
+void Counter::getRecord(Record &rec){
+	stop();
+	rec.xSampleMs = xStopTime - xStartTime;
+	window(rec.xCounts);
 }
 
 void Counter::report(){
 	char line[80];
-	 xStopTime =  to_ms_since_boot(get_absolute_time());
+	TextBuffer text(line, sizeof(line));
+	Record rec;
+	getRecord(rec);
+
+	uint32_t sampleTime = rec.xSampleMs;
+	Counts::Snapshot &counts = rec.xCounts;
+
+	text.add("Sampled over ").addUnsigned(sampleTime / 1000)
+		.add(" sec and ").addUnsigned(sampleTime % 1000).add(" ms\n\r");
+	print(text.c_str());
+	print("#\t+Id\t+Core\n\r");
+	uint32_t total = 0;
+	for (int i = 0; i < MAX_ID; i++){
+		text.clear();
+		text.addUnsigned(i).add(":\t").addUnsigned(counts.xIds[i]).add('\r');
+		if (i < MAX_CORES){
+			text.add('\t').addUnsigned(counts.xCores[i]);
+		}
+		text.add("\n\r");
+		print(text.c_str());
+		total += counts.xIds[i] ;
+	}
 
-	 uint32_t sampleTime = xStopTime - xStartTime;
+	//Per second to 3 decimal places without floating point
+	uint64_t perSecMilli = (sampleTime > 0) ?
+			((uint64_t)total * 1000000ULL) / sampleTime : 0;
 
-	 sprintf(line, "Sampled over %d sec and %d ms\n\r", sampleTime/1000, sampleTime%1000);
-	 print(line);
-	 print("#\t+Id\t+Core\n\r");
-	 uint32_t total = 0;
-	 for (int i = 0; i < MAX_ID; i++){
-		 sprintf(line,"%d:\t%u\r", i, xCounts[i]);
-		 print(line);
-		 if (i < MAX_CORES){
-			 sprintf(line,"\t%u\n\r", xCoreCounts[i]);
-			 print(line);
-		 } else {
-			 print("\n\r");
-		 }
-		total += xCounts[i] ;
-	 }
+	text.clear();
+	text.add("Total: ").addUnsigned(total).add(" \t")
+		.addFixed(perSecMilli, 3).add(" per sec\n\r");
+	print(text.c_str());
 
-	 double perSec = (double)total /  ((double) sampleTime / 1000.0);
+	//Machine readable summary for tools/bench_matrix.py
+	text.clear();
+	text.add("RESULT variant=").add(PICALC_VARIANT)
+		.add(" ms=").addUnsigned(sampleTime)
+		.add(" total=").addUnsigned(total)
+		.add(" persec=").addFixed(perSecMilli, 3).add("\n\r");
+	print(text.c_str());
+
+	print("Job us\t+Min\t+P50\t+P90\t+P99\t+Max\n\r");
+	for (int i = 0; i < MAX_ID; i++){
+		text.clear();
+		text.add("Id ").addUnsigned(i);
+		printJobs(text.c_str(), pIdJobs[i]);
+	}
+	for (int i = 0; i < MAX_CORES; i++){
+		text.clear();
+		text.add("Core ").addUnsigned(i);
+		printJobs(text.c_str(), pCoreJobs[i]);
+	}
+}
 
-	 sprintf(line,"Total: %u \t%f per sec\n\r", total, perSec);
-	 print(line);
 
+uint32_t Counter::getTotal(){
+	Counts::Snapshot counts;
+	window(counts);
+	return counts.total();
 }
 
+/***
+ * Length of the sample window, up to now if still open
+ * @return ms
+ */
+uint32_t Counter::getSampleMs(){
+	uint32_t end = xStopTime;
+	if (end == 0){
+		end = to_ms_since_boot(get_absolute_time());
+	}
+	return end - xStartTime;
+}
 
-void Counter::getCores(uint32_t &core0, uint32_t &core1){
-	core0 = xCoreCounts[0];
-	core1 = xCoreCounts[1];
+void Counter::setReporter(Reporter *reporter){
+	pReporter = reporter;
 }
 
 void Counter::print(const char *s){
-	if (pUart != NULL){
+	if (pReporter != NULL){
+		pReporter->write(s);
+	} else if (pUart != NULL){
 		uart_puts (pUart,  s);
 	} else {
-		printf(s);
+		fputs(s, stdout);
 	}
 }
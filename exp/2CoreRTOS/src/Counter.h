@@ -10,24 +10,72 @@
 
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
+#include "ShardedCounter.h"
+#include "Histogram.h"
+#include "MetricRegistry.h"
 
 #define MAX_ID 4
 #define MAX_CORES 2
 
+class Reporter;
+
 class Counter {
 public:
+	typedef ShardedCounter<MAX_ID, MAX_CORES> Counts;
+
+	/***
+	 * Fixed record of a closed sample window
+	 */
+	struct Record {
+		uint32_t xSampleMs;
+		Counts::Snapshot xCounts;
+	};
+
 	virtual ~Counter();
 
 	static Counter * getInstance(uart_inst_t *uart = NULL);
 
 	void setUart(uart_inst_t *uart);
 
+	/***
+	 * Send all output through a Reporter instead of the UART directly
+	 * @param reporter - NULL to write directly again
+	 */
+	void setReporter(Reporter *reporter);
+
 	void start();
+	void stop();
 	void inc(uint8_t id=0);
 	void incCore(uint8_t id=0, uint8_t  core=0);
 	void report();
 
-	void getCores(uint32_t &core0, uint32_t &core1);
+	/***
+	 * Record of the sample window, closing it if still open
+	 * @param rec - filled in
+	 */
+	void getRecord(Record &rec);
+
+	/***
+	 * Record how long one job took, for the id and the calling core.
+	 * Each id must only be recorded by one task.
+	 * @param id
+	 * @param ns
+	 */
+	void recordJob(uint8_t id, uint32_t ns);
+
+	/***
+	 * Job time histograms for the current window, in ns. They live in
+	 * the MetricRegistry as job.idN and job.coreN. The job counts stay
+	 * in the sharded counter and are exported through the registry as
+	 * count.idN and count.coreN.
+	 * @param id
+	 * @return NULL if id or core is out of range or the registry is full
+	 */
+	const Histogram *getIdJobs(uint8_t id);
+	const Histogram *getCoreJobs(uint8_t core);
+
+	uint32_t getTotal();
+	uint32_t getSampleMs();
 
 	void print(const char *s);
 
@@ -37,12 +85,29 @@ private:
 
 	static Counter *pSingleton;
 
+	/***
+	 * Counts in the sample window, frozen once stopped
+	 * @param snap
+	 */
+	void window(Counts::Snapshot &snap);
+
+	/***
+	 * Print one row of the job time table
+	 * @param label
+	 * @param hist
+	 */
+	void printJobs(const char *label, const Histogram *hist);
+
 	uint32_t xStartTime;
-	uint32_t xStopTime = 0;
-	uint32_t xCounts[MAX_ID];
-	uint32_t xCoreCounts[MAX_CORES];
+	volatile uint32_t xStopTime = 0;
+	Counts xCounts;
+	Counts::Snapshot xStart;
+	Counts::Snapshot xStop;
+	Histogram *pIdJobs[MAX_ID];
+	Histogram *pCoreJobs[MAX_CORES];
 
 	uart_inst_t * pUart = NULL;
+	Reporter * pReporter = NULL;
 
 };
 
@@ -0,0 +1,262 @@
+/*
+ * CpuMonitor.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "CpuMonitor.h"
+#include "TextBuffer.h"
+#include <cstring>
+
+static_assert(TRACE_MAX_TASKS > AGENT_REGISTRY_MAX + 1, "TRACE_MAX_TASKS leaves no numbers for other tasks");
+static_assert(TRACE_MAX_TASKS <= 100, "cpu gauge names have two digits for the task");
+
+static const char * const idleNames[MAX_CORES] = {
+	"cpu.idle0", "cpu.idle1"
+};
+
+CpuMonitor::CpuMonitor() {
+	for (uint8_t n = 0; n < TRACE_MAX_TASKS; n++){
+		pNames[n] = NULL;
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			pUse[n][c] = NULL;
+		}
+	}
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xIdle[c] = 0;
+		pIdleUse[c] = NULL;
+	}
+	memset(xWindow, 0, sizeof(xWindow));
+	memset(&xFirst, 0, sizeof(xFirst));
+}
+
+CpuMonitor::~CpuMonitor() {
+	// NOP
+}
+
+bool CpuMonitor::addTelemetry(Agent *agent){
+	if (xTelemetry >= CPU_MAX_TELEMETRY){
+		return false;
+	}
+	pTelemetry[xTelemetry++] = agent;
+	return true;
+}
+
+void CpuMonitor::sample(){
+	Snapshot &snap = xWindow[xSamples % CPU_WINDOW];
+	take(snap);
+	addGauges();
+
+	if (xSamples == 0){
+		xFirst = snap;
+	} else {
+		//Oldest snapshot still held, the slot after the one just written
+		uint32_t oldest = (xSamples >= CPU_WINDOW) ? ((xSamples + 1) % CPU_WINDOW) : 0;
+		publish(xWindow[oldest], snap);
+	}
+	xSamples++;
+}
+
+void CpuMonitor::take(Snapshot &snap){
+	bool named = false;
+	UBaseType_t n = uxTaskGetSystemState(xStatus, CPU_MAX_TASKS, NULL);
+
+	memset(snap.xRunUs, 0, sizeof(snap.xRunUs));
+	for (UBaseType_t t = 0; t < n; t++){
+		TaskHandle_t handle = xStatus[t].xHandle;
+		UBaseType_t number = uxTaskGetTaskNumber(handle);
+
+		if (number == 0){
+			//Agents are numbered by Agent::start, leave them to it
+			bool agent = false;
+			for (uint8_t s = 0; s < AgentRegistry::getSlots(); s++){
+				Agent *a = AgentRegistry::getAgent(s);
+				if ((a != NULL) && (a->getTask() == handle)){
+					agent = true;
+				}
+			}
+			if (agent || (xNextNumber >= TRACE_MAX_TASKS)){
+				continue;
+			}
+			number = xNextNumber++;
+			vTaskSetTaskNumber(handle, number);
+			pNames[number] = xStatus[t].pcTaskName;
+			named = true;
+		}
+
+		if (number < TRACE_MAX_TASKS){
+			snap.xRunUs[number] = xStatus[t].ulRunTimeCounter;
+		}
+	}
+
+	for (uint8_t t = 0; t < TRACE_MAX_TASKS; t++){
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			snap.xResidentUs[t][c] = ulTraceGetResidentUs(t, c);
+		}
+	}
+	snap.xTimeUs = time_us_64();
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xIdle[c] = (uint8_t)uxTaskGetTaskNumber(xTaskGetIdleTaskHandleForCore(c));
+	}
+
+	if (named){
+		publishNames();
+	}
+}
+
+/***
+ * Share of a period in per mille
+ * @param us
+ * @param periodUs
+ * @return
+ */
+static uint16_t perMille(uint64_t us, uint64_t periodUs){
+	if (periodUs == 0){
+		return 0;
+	}
+	uint64_t share = (us * 1000) / periodUs;
+	return (share > 1000) ? 1000 : (uint16_t)share;
+}
+
+void CpuMonitor::publish(const Snapshot &from, const Snapshot &to){
+	uint64_t windowUs = to.xTimeUs - from.xTimeUs;
+	uint64_t idleUs = 0;
+	uint64_t telemetryUs = 0;
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		uint64_t coreIdle = 0;
+		for (uint8_t t = 1; t < TRACE_MAX_TASKS; t++){
+			//Residency is 32 bit, the difference is right for windows under 71 minutes
+			uint32_t us = to.xResidentUs[t][c] - from.xResidentUs[t][c];
+			if (pUse[t][c] != NULL){
+				pUse[t][c]->set(perMille(us, windowUs));
+			}
+			if (isIdle(t)){
+				coreIdle += us;
+			}
+		}
+		if (pIdleUse[c] != NULL){
+			pIdleUse[c]->set(perMille(coreIdle, windowUs));
+		}
+		idleUs += coreIdle;
+	}
+
+	for (uint8_t t = 1; t < TRACE_MAX_TASKS; t++){
+		if (isTelemetry(t) && (to.xRunUs[t] > from.xRunUs[t])){
+			telemetryUs += to.xRunUs[t] - from.xRunUs[t];
+		}
+	}
+	uint64_t capacityUs = windowUs * MAX_CORES;
+	uint64_t busyUs = (capacityUs > idleUs) ? capacityUs - idleUs : 0;
+	if (pTelemetryUse != NULL){
+		pTelemetryUse->set(perMille(telemetryUs, busyUs));
+	}
+}
+
+void CpuMonitor::addGauges(){
+	MetricRegistry *registry = MetricRegistry::getInstance();
+	if (!xGauges){
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			pIdleUse[c] = registry->gauge(idleNames[c]);
+		}
+		pTelemetryUse = registry->gauge("cpu.telemetry");
+		xGauges = true;
+	}
+
+	for (uint8_t t = 1; t < TRACE_MAX_TASKS; t++){
+		if ((pUse[t][0] != NULL) || (taskName(t) == NULL)){
+			continue;
+		}
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			TextBuffer text(xUseNames[t][c], CPU_GAUGE_NAME);
+			text.add("cpu.").addUnsigned(t - 1).add(".c").addUnsigned(c);
+			pUse[t][c] = registry->gauge(xUseNames[t][c]);
+		}
+	}
+}
+
+bool CpuMonitor::isTelemetry(uint8_t number){
+	for (uint8_t i = 0; i < xTelemetry; i++){
+		if (pTelemetry[i]->getSlot() + 1 == number){
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CpuMonitor::isIdle(uint8_t number){
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		if ((xIdle[c] != 0) && (xIdle[c] == number)){
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *CpuMonitor::taskName(uint8_t number){
+	if (pNames[number] != NULL){
+		return pNames[number];
+	}
+	Agent *agent = AgentRegistry::getAgent(number - 1);
+	if (agent == NULL){
+		return NULL;
+	}
+	return agent->getName();
+}
+
+void CpuMonitor::publishNames(){
+	char msg[128];
+	TextBuffer text(msg, sizeof(msg));
+	text.add("Tasks:");
+	for (uint8_t t = AGENT_REGISTRY_MAX + 1; t < xNextNumber; t++){
+		text.add(' ').addUnsigned(t - 1).add('=').add(pNames[t]);
+	}
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+}
+
+void CpuMonitor::report(Counter *counter){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	if (xSamples < 2){
+		return;
+	}
+	const Snapshot &last = xWindow[(xSamples - 1) % CPU_WINDOW];
+	uint64_t periodUs = last.xTimeUs - xFirst.xTimeUs;
+	uint64_t busyUs = 0;
+	uint64_t telemetryUs = 0;
+
+	text.add("CPU use over ").addUnsigned(periodUs / 1000).add(" ms\n\r");
+	counter->print(text.c_str());
+	counter->print("Task\t\t+Core 0\t+Core 1\t+Run ms\n\r");
+	for (uint8_t t = 1; t < TRACE_MAX_TASKS; t++){
+		const char *name = taskName(t);
+		if (name == NULL){
+			continue;
+		}
+		uint32_t core0 = last.xResidentUs[t][0] - xFirst.xResidentUs[t][0];
+		uint32_t core1 = last.xResidentUs[t][1] - xFirst.xResidentUs[t][1];
+		uint64_t runUs = (last.xRunUs[t] > xFirst.xRunUs[t]) ?
+				last.xRunUs[t] - xFirst.xRunUs[t] : 0;
+		if (!isIdle(t)){
+			busyUs += runUs;
+		}
+		if (isTelemetry(t)){
+			telemetryUs += runUs;
+		}
+
+		text.clear();
+		text.add(name, 15)
+			.add('\t').addFixed(perMille(core0, periodUs), 1)
+			.add("%\t").addFixed(perMille(core1, periodUs), 1)
+			.add("%\t").addUnsigned(runUs / 1000).add("\n\r");
+		counter->print(text.c_str());
+	}
+
+	text.clear();
+	text.add("Telemetry ").addFixed(perMille(telemetryUs, busyUs), 1)
+		.add("% of busy time\n\r");
+	counter->print(text.c_str());
+}
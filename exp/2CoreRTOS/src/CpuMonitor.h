@@ -0,0 +1,138 @@
+/*
+ * CpuMonitor.h
+ *
+ * CPU use of every task on each core over a sliding window. The split
+ * by core comes from the residency the trace hooks charge at each
+ * switch, the run time of a task from the kernel run time stats on
+ * the 64 bit microsecond timer.
+ *
+ * Agents are numbered by their registry slot when started. Other tasks,
+ * the idle tasks, timer service and main, are given the numbers after
+ * the registry so the hooks account for them too.
+ *
+ * Use is published as MetricRegistry gauges in per mille of one core:
+ * cpu.N.cC for task number N+1 on core C, registered when the task is
+ * first seen, cpu.idle0, cpu.idle1 and cpu.telemetry.
+ *
+ * Not an Agent, sample is called once a second by TSTMetrics.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_CPUMONITOR_H_
+#define EXP_2CORERTOS_SRC_CPUMONITOR_H_
+
+#include "Agent.h"
+#include "AgentRegistry.h"
+#include "Counter.h"
+#include "MetricRegistry.h"
+#include "pico/stdlib.h"
+#include "traceHooks.h"
+extern "C"{
+#include "tst_variables.h"
+}
+
+#define CPU_WINDOW			5		//Samples in the sliding window
+#define CPU_MAX_TASKS		24		//Tasks read from the kernel per sample
+#define CPU_MAX_TELEMETRY	8
+#define CPU_GAUGE_NAME		10		//"cpu.NN.cC"
+
+class CpuMonitor {
+public:
+	CpuMonitor();
+	virtual ~CpuMonitor();
+
+	/***
+	 * Count an agent as telemetry, its time is the cost of observing
+	 * @param agent
+	 * @return false if CPU_MAX_TELEMETRY are already added
+	 */
+	bool addTelemetry(Agent *agent);
+
+	/***
+	 * Take a sample and publish use over the window to the gauges
+	 */
+	void sample();
+
+	/***
+	 * Print use since the first sample
+	 * @param counter - used for output
+	 */
+	void report(Counter *counter);
+
+	/***
+	 * Name of a task by number
+	 * @param number - below TRACE_MAX_TASKS
+	 * @return NULL if not known
+	 */
+	const char *taskName(uint8_t number);
+
+private:
+	/***
+	 * Run time of every task and where it ran, by task number
+	 */
+	struct Snapshot {
+		uint64_t xTimeUs;
+		uint64_t xRunUs[TRACE_MAX_TASKS];
+		uint32_t xResidentUs[TRACE_MAX_TASKS][MAX_CORES];
+	};
+
+	/***
+	 * Number tasks that are not agents and read the counters. Residency
+	 * includes the slice each core is part way through.
+	 * @param snap - filled in
+	 */
+	void take(Snapshot &snap);
+
+	/***
+	 * Publish use between two snapshots
+	 * @param from
+	 * @param to
+	 */
+	void publish(const Snapshot &from, const Snapshot &to);
+
+	/***
+	 * Is a task number one of the telemetry agents
+	 * @param number
+	 * @return
+	 */
+	bool isTelemetry(uint8_t number);
+
+	/***
+	 * Is a task number an idle task
+	 * @param number
+	 * @return
+	 */
+	bool isIdle(uint8_t number);
+
+	/***
+	 * Send names of the numbered tasks that are not agents to the monitor
+	 */
+	void publishNames();
+
+	/***
+	 * Register the gauges of any task seen since the last sample
+	 */
+	void addGauges();
+
+	TaskStatus_t xStatus[CPU_MAX_TASKS];
+	const char *pNames[TRACE_MAX_TASKS];
+	uint8_t xNextNumber = AGENT_REGISTRY_MAX + 1;
+	uint8_t xIdle[MAX_CORES];
+
+	Agent *pTelemetry[CPU_MAX_TELEMETRY];
+	uint8_t xTelemetry = 0;
+
+	MetricGauge *pUse[TRACE_MAX_TASKS][MAX_CORES];
+	char xUseNames[TRACE_MAX_TASKS][MAX_CORES][CPU_GAUGE_NAME];
+	MetricGauge *pIdleUse[MAX_CORES];
+	MetricGauge *pTelemetryUse = NULL;
+	bool xGauges = false;
+
+	Snapshot xWindow[CPU_WINDOW];
+	uint32_t xSamples = 0;
+	Snapshot xFirst;
+};
+
+#endif /* EXP_2CORERTOS_SRC_CPUMONITOR_H_ */
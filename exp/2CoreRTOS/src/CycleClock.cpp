@@ -0,0 +1,61 @@
+/*
+ * CycleClock.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "CycleClock.h"
+#include "hardware/clocks.h"
+
+uint32_t CycleClock::xSysHz = 0;
+
+bool CycleClock::enable(){
+#if CYCLECLOCK_DWT
+	//m33_hw is on the private bus, so this is the calling core's DWT
+	if (m33_hw->dwt_ctrl & M33_DWT_CTRL_NOCYCCNT_BITS){
+		return false;
+	}
+	if (!(m33_hw->dwt_ctrl & M33_DWT_CTRL_CYCCNTENA_BITS)){
+		m33_hw->demcr = m33_hw->demcr | M33_DEMCR_TRCENA_BITS;
+		m33_hw->dwt_cyccnt = 0;
+		m33_hw->dwt_ctrl = m33_hw->dwt_ctrl | M33_DWT_CTRL_CYCCNTENA_BITS;
+	}
+	if (xSysHz == 0){
+		xSysHz = clock_get_hz(clk_sys);
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void CycleClock::start(Stamp &stamp){
+	stamp.xCore = get_core_num();
+	stamp.xUs = time_us_64();
+#if CYCLECLOCK_DWT
+	if (enable()){
+		stamp.xCycles = m33_hw->dwt_cyccnt;
+		return;
+	}
+#endif
+	stamp.xCycles = 0;
+	stamp.xCore = 0xFF;
+}
+
+uint32_t CycleClock::elapsedNs(const Stamp &stamp){
+	uint64_t ns;
+#if CYCLECLOCK_DWT
+	uint32_t cycles = m33_hw->dwt_cyccnt - stamp.xCycles;
+	if ((stamp.xCore == get_core_num()) && (xSysHz != 0)){
+		ns = ((uint64_t)cycles * 1000000000ULL) / xSysHz;
+		//Counter wraps every few seconds, trust the timer beyond that
+		uint64_t us = time_us_64() - stamp.xUs;
+		if (us < ((uint64_t)UINT32_MAX * 1000000ULL / xSysHz) / 2){
+			return (uint32_t)ns;
+		}
+	}
+#endif
+	ns = (time_us_64() - stamp.xUs) * 1000;
+	return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
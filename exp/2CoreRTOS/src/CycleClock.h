@@ -0,0 +1,76 @@
+/*
+ * CycleClock.h
+ *
+ * Times short sections of code with the Cortex-M33 DWT cycle counter.
+ * Each core has its own counter, so a section that starts on one core
+ * and ends on the other, or a build without the DWT, falls back to
+ * time_us_64.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_CYCLECLOCK_H_
+#define EXP_2CORERTOS_SRC_CYCLECLOCK_H_
+
+#include "pico/stdlib.h"
+
+#if PICO_RP2350 && !defined(__riscv)
+#define CYCLECLOCK_DWT 1
+#else
+#define CYCLECLOCK_DWT 0
+#endif
+
+#if CYCLECLOCK_DWT
+#include "hardware/structs/m33.h"
+#endif
+
+class CycleClock {
+public:
+	/***
+	 * Start of a timed section
+	 */
+	struct Stamp {
+		uint32_t xCycles;
+		uint64_t xUs;
+		uint8_t  xCore;
+	};
+
+	/***
+	 * Mark the start of a section, enabling the counter on this core
+	 * if needed
+	 * @param stamp - filled in
+	 */
+	static void start(Stamp &stamp);
+
+	/***
+	 * Time since start
+	 * @param stamp
+	 * @return ns, saturates at about 4.2 seconds
+	 */
+	static uint32_t elapsedNs(const Stamp &stamp);
+
+	/***
+	 * Make sure the cycle counter runs on the calling core
+	 * @return false if this core has no cycle counter
+	 */
+	static bool enable();
+
+	/***
+	 * Cycle count of the calling core, only meaningful once enable has
+	 * returned true on that core
+	 * @return
+	 */
+	static inline uint32_t cycles(){
+#if CYCLECLOCK_DWT
+		return m33_hw->dwt_cyccnt;
+#else
+		return 0;
+#endif
+	}
+
+private:
+	static uint32_t xSysHz;
+};
+
+#endif /* EXP_2CORERTOS_SRC_CYCLECLOCK_H_ */
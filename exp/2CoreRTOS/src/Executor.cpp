@@ -0,0 +1,109 @@
+/*
+ * Executor.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "Executor.h"
+#include "TextBuffer.h"
+
+Executor *Executor::pSingleton = NULL;
+
+
+ExecutorCore::ExecutorCore() {
+	xQueue = xQueueCreateStatic(
+			EXECUTOR_QUEUE_LEN,
+			sizeof(ExecutorJob *),
+			xQueueStorage,
+			&xQueueBuffer);
+}
+
+ExecutorCore::~ExecutorCore() {
+	stop();
+}
+
+void ExecutorCore::setCore(uint8_t core){
+	xCore = core;
+}
+
+bool ExecutorCore::post(ExecutorJob *job){
+	if ((getTask() == NULL) || hasExited()){
+		return false;
+	}
+	return (xQueueSend(xQueue, &job, portMAX_DELAY) == pdTRUE);
+}
+
+/***
+ * Task main run loop
+ */
+void ExecutorCore::run(){
+	UBaseType_t uxCoreAffinityMask;
+	uxCoreAffinityMask = ( ( 1 << xCore ) );
+	vTaskCoreAffinitySet( xHandle, uxCoreAffinityMask );
+
+	ExecutorJob *job;
+	for (;;){
+		if (xQueueReceive(xQueue, &job, portMAX_DELAY) == pdTRUE){
+			heartbeat();
+			job->xFn();
+			xTaskNotifyGiveIndexed(job->xNotify, EXECUTOR_NOTIFY_INDEX);
+		}
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE ExecutorCore::getMaxStackSize(){
+	return STACK_BUDGET(ExecutorCore);
+}
+
+
+Executor::Executor() {
+	for (uint8_t i = 0; i < EXECUTOR_MAX_CORES; i++){
+		xWorkers[i].setCore(i);
+	}
+}
+
+Executor::~Executor() {
+	// NOP
+}
+
+Executor * Executor::getInstance(){
+	if (Executor::pSingleton == NULL){
+		Executor::pSingleton = new Executor;
+	}
+	return Executor::pSingleton;
+}
+
+bool Executor::start(UBaseType_t priority){
+	char name[MAX_NAME_LEN];
+	TextBuffer text(name, sizeof(name));
+	bool res = true;
+	for (uint8_t i = 0; i < xCores; i++){
+		text.clear();
+		text.add("Exec ").addUnsigned(i);
+		res = xWorkers[i].start(name, priority) && res;
+	}
+	return res;
+}
+
+uint8_t Executor::getCores(){
+	return xCores;
+}
+
+bool Executor::submit(uint8_t core, ExecutorJob &job){
+	if (core >= xCores){
+		return false;
+	}
+	job.xNotify = xTaskGetCurrentTaskHandle();
+	return xWorkers[core].post(&job);
+}
+
+void Executor::join(uint8_t count){
+	for (uint8_t i = 0; i < count; i++){
+		ulTaskNotifyTakeIndexed(EXECUTOR_NOTIFY_INDEX, pdFALSE, portMAX_DELAY);
+	}
+}
@@ -0,0 +1,207 @@
+/*
+ * Executor.h
+ *
+ * Fork/join executor with one worker task pinned to each core.
+ * Jobs are small buffer callables held on the caller's stack, so
+ * submitting work never allocates.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_EXECUTOR_H_
+#define EXP_2CORERTOS_SRC_EXECUTOR_H_
+
+#include "Agent.h"
+#include "InplaceFunction.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#define EXECUTOR_MAX_CORES 	configNUMBER_OF_CORES
+#define EXECUTOR_QUEUE_LEN	8
+#define EXECUTOR_JOB_SIZE	32
+//Task notification index used to signal a job done to its submitter,
+//kept apart from the Agent indexes so no other give can end a join
+#define EXECUTOR_NOTIFY_INDEX	3
+
+static_assert(EXECUTOR_NOTIFY_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES,
+		"configTASK_NOTIFICATION_ARRAY_ENTRIES too small for the Executor");
+
+/***
+ * A unit of work. Lives on the submitting task's stack until it
+ * has been joined.
+ */
+struct ExecutorJob {
+	InplaceFunction<void(), EXECUTOR_JOB_SIZE> xFn;
+	TaskHandle_t xNotify = NULL;
+};
+
+/***
+ * Worker task for one core
+ */
+class ExecutorCore : public Agent {
+public:
+	ExecutorCore();
+	virtual ~ExecutorCore();
+
+	/***
+	 * Set the core this worker is pinned to
+	 * @param core
+	 */
+	void setCore(uint8_t core);
+
+	/***
+	 * Queue a job for this core
+	 * @param job - must remain valid until completion is notified
+	 * @return false if the worker is not running, the job will not run
+	 */
+	bool post(ExecutorJob *job);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	uint8_t xCore = 0;
+
+	QueueHandle_t xQueue = NULL;
+	StaticQueue_t xQueueBuffer;
+	uint8_t xQueueStorage[EXECUTOR_QUEUE_LEN * sizeof(ExecutorJob *)];
+};
+
+
+class Executor {
+public:
+	virtual ~Executor();
+
+	static Executor * getInstance();
+
+	/***
+	 * Start one worker task per core
+	 * @param priority - should be above the tasks that submit work
+	 * @return
+	 */
+	bool start(UBaseType_t priority);
+
+	/***
+	 * Number of cores work is split over
+	 * @return
+	 */
+	uint8_t getCores();
+
+	/***
+	 * Run job on the given core. Caller must join it if accepted.
+	 * @param core
+	 * @param job
+	 * @return false if not accepted, nothing is signalled for it
+	 */
+	bool submit(uint8_t core, ExecutorJob &job);
+
+	/***
+	 * Block until count accepted jobs have completed
+	 * @param count
+	 */
+	void join(uint8_t count);
+
+	/***
+	 * Split [begin, end) into one chunk per core and run
+	 * body(from, to) for each chunk. Returns when all chunks are done.
+	 * Must be called from a task, not from one of the executor workers.
+	 * @param begin
+	 * @param end
+	 * @param body - callable taking (uint32_t from, uint32_t to)
+	 */
+	template<typename Body>
+	void parallel_for(uint32_t begin, uint32_t end, Body &&body){
+		ExecutorJob jobs[EXECUTOR_MAX_CORES];
+		uint8_t pending;
+		split(begin, end, [&](uint8_t i, uint32_t from, uint32_t to){
+			jobs[i].xFn = [&body, from, to](){
+				body(from, to);
+			};
+		}, jobs, pending);
+		join(pending);
+	}
+
+	/***
+	 * Split [begin, end) into one chunk per core, compute map(from, to)
+	 * on each and fold the partial results with combine.
+	 * @param begin
+	 * @param end
+	 * @param init - initial value of the fold
+	 * @param map - callable (uint32_t from, uint32_t to) -> T
+	 * @param combine - callable (T, T) -> T
+	 * @return folded result
+	 */
+	template<typename T, typename Map, typename Combine>
+	T parallel_reduce(uint32_t begin, uint32_t end, T init,
+			Map &&map, Combine &&combine){
+		ExecutorJob jobs[EXECUTOR_MAX_CORES];
+		T partial[EXECUTOR_MAX_CORES];
+		uint8_t pending;
+		uint8_t n = split(begin, end, [&](uint8_t i, uint32_t from, uint32_t to){
+			T *out = &partial[i];
+			jobs[i].xFn = [&map, out, from, to](){
+				*out = map(from, to);
+			};
+		}, jobs, pending);
+		join(pending);
+
+		T res = init;
+		for (uint8_t i = 0; i < n; i++){
+			res = combine(res, partial[i]);
+		}
+		return res;
+	}
+
+protected:
+	Executor();
+
+private:
+	/***
+	 * Build and submit one job per non empty chunk. A job a core does
+	 * not accept is run here instead so every chunk is done.
+	 * @param pending - set to the number of jobs accepted, to join
+	 * @return number of chunks
+	 */
+	template<typename Build>
+	uint8_t split(uint32_t begin, uint32_t end, Build &&build,
+			ExecutorJob *jobs, uint8_t &pending){
+		pending = 0;
+		if (end <= begin){
+			return 0;
+		}
+		uint32_t len = end - begin;
+		uint8_t n = (len < xCores) ? len : xCores;
+		uint32_t chunk = len / n;
+		uint32_t rem = len % n;
+		uint32_t from = begin;
+		for (uint8_t i = 0; i < n; i++){
+			uint32_t to = from + chunk + ((i < rem) ? 1 : 0);
+			build(i, from, to);
+			if (submit(i, jobs[i])){
+				pending++;
+			} else {
+				jobs[i].xFn();
+			}
+			from = to;
+		}
+		return n;
+	}
+
+	static Executor *pSingleton;
+
+	ExecutorCore xWorkers[EXECUTOR_MAX_CORES];
+	uint8_t xCores = EXECUTOR_MAX_CORES;
+};
+
+#endif /* EXP_2CORERTOS_SRC_EXECUTOR_H_ */
@@ -0,0 +1,91 @@
+/*
+ * ExecutorBench.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "ExecutorBench.h"
+#include "Executor.h"
+#include "Counter.h"
+#include "TextBuffer.h"
+
+ExecutorBench::ExecutorBench() {
+	for (uint32_t i = 0; i < EXECUTOR_BENCH_BUF; i++){
+		xBuf[i] = i * 2654435761u;
+	}
+}
+
+ExecutorBench::~ExecutorBench() {
+	stop();
+}
+
+/***
+ * Task main run loop
+ */
+void ExecutorBench::run(){
+	Counter *c = Counter::getInstance();
+	c->print("Executor fork/join\n\r");
+	c->print("Words\tSerial us\tParallel us\tOverhead us\n\r");
+
+	for (uint32_t len = 1; len <= EXECUTOR_BENCH_BUF; len *= 4){
+		measure(len);
+	}
+
+	for (;;){
+		vTaskDelay(3000);
+	}
+}
+
+void ExecutorBench::measure(uint32_t len){
+	Executor *exec = Executor::getInstance();
+	const uint32_t *buf = xBuf;
+	volatile uint32_t sink = 0;
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	auto checksum = [buf](uint32_t from, uint32_t to){
+		uint32_t sum = 0;
+		for (uint32_t i = from; i < to; i++){
+			sum = (sum << 1 | sum >> 31) ^ buf[i];
+		}
+		return sum;
+	};
+	auto combine = [](uint32_t a, uint32_t b){
+		return a ^ b;
+	};
+
+	//The barrier tells the compiler buf may have changed, so the pure
+	//checksum is redone each repetition rather than hoisted out
+	uint64_t start = time_us_64();
+	for (int r = 0; r < EXECUTOR_BENCH_REPS; r++){
+		__asm volatile("" ::: "memory");
+		sink = checksum(0, len);
+	}
+	uint32_t serial = (uint32_t)(time_us_64() - start);
+
+	start = time_us_64();
+	for (int r = 0; r < EXECUTOR_BENCH_REPS; r++){
+		__asm volatile("" ::: "memory");
+		sink = exec->parallel_reduce(0, len, (uint32_t)0, checksum, combine);
+	}
+	uint32_t parallel = (uint32_t)(time_us_64() - start);
+	(void)sink;
+
+	//Ideal parallel time is serial / cores, anything above is fork/join cost
+	int32_t overhead = (int32_t)parallel - (int32_t)(serial / exec->getCores());
+
+	text.addUnsigned(len)
+		.add('\t').addUnsigned(serial / EXECUTOR_BENCH_REPS)
+		.add('\t').addUnsigned(parallel / EXECUTOR_BENCH_REPS)
+		.add('\t').addSigned(overhead / EXECUTOR_BENCH_REPS).add("\n\r");
+	Counter::getInstance()->print(text.c_str());
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE ExecutorBench::getMaxStackSize(){
+	return STACK_BUDGET(ExecutorBench);
+}
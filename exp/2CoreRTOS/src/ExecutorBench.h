@@ -0,0 +1,46 @@
+/*
+ * ExecutorBench.h
+ *
+ * Measure fork/join overhead of the Executor against range size
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_EXECUTORBENCH_H_
+#define EXP_2CORERTOS_SRC_EXECUTORBENCH_H_
+
+#include "Agent.h"
+#include "pico/stdlib.h"
+
+#define EXECUTOR_BENCH_BUF	4096
+#define EXECUTOR_BENCH_REPS	50
+
+class ExecutorBench : public Agent {
+public:
+	ExecutorBench();
+	virtual ~ExecutorBench();
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Time serial and parallel checksum over len words
+	 * @param len
+	 */
+	void measure(uint32_t len);
+
+	uint32_t xBuf[EXECUTOR_BENCH_BUF];
+};
+
+#endif /* EXP_2CORERTOS_SRC_EXECUTORBENCH_H_ */
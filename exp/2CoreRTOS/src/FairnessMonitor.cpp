@@ -0,0 +1,202 @@
+/*
+ * FairnessMonitor.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "FairnessMonitor.h"
+#include "TextBuffer.h"
+#include "traceHooks.h"
+
+FairnessMonitor::FairnessMonitor() {
+	for (uint8_t i = 0; i < MAX_ID; i++){
+		pWorkers[i] = NULL;
+		xStartLoops[i] = 0;
+		xWindowLoops[i] = 0;
+		xReadySamples[i] = 0;
+		xStartRunUs[i] = 0;
+	}
+	for (uint8_t i = 0; i < MAX_CORES; i++){
+		xReadyLen[i] = 0;
+		xWindowReadyLen[i] = 0;
+	}
+}
+
+FairnessMonitor::~FairnessMonitor() {
+	stop();
+}
+
+bool FairnessMonitor::addWorker(Agent *worker){
+	if (xWorkers >= MAX_ID){
+		return false;
+	}
+	pWorkers[xWorkers++] = worker;
+	return true;
+}
+
+/***
+ * Task main run loop
+ */
+void FairnessMonitor::run(){
+	for (uint8_t i = 0; i < xWorkers; i++){
+		xStartLoops[i] = pWorkers[i]->getLoops();
+		xWindowLoops[i] = xStartLoops[i];
+		xStartRunUs[i] = runUs(i);
+	}
+	xStartUs = time_us_32();
+
+	TickType_t wake = xTaskGetTickCount();
+	while (!isStopRequested()){
+		heartbeat();
+		sample();
+		if (xWindowSamples >= FAIRNESS_WINDOW){
+			closeWindow();
+		}
+		xTaskDelayUntil(&wake, pdMS_TO_TICKS(FAIRNESS_SAMPLE_MS));
+	}
+}
+
+void FairnessMonitor::sample(){
+	UBaseType_t n = uxTaskGetSystemState(xStatus, FAIRNESS_MAX_TASKS, NULL);
+	if (n == 0){
+		xMissed++;
+		return;
+	}
+
+	for (UBaseType_t t = 0; t < n; t++){
+		eTaskState state = xStatus[t].eCurrentState;
+
+		//A ready task is queued on every core it may run on
+		if (state == eReady){
+			for (uint8_t c = 0; c < MAX_CORES; c++){
+				if (xStatus[t].uxCoreAffinityMask & (1 << c)){
+					xReadyLen[c]++;
+					xWindowReadyLen[c]++;
+				}
+			}
+		}
+
+		for (uint8_t w = 0; w < xWorkers; w++){
+			if (pWorkers[w]->getTask() == xStatus[t].xHandle){
+				if (state == eReady){
+					xReadySamples[w]++;
+				}
+			}
+		}
+	}
+	xSamples++;
+	xWindowSamples++;
+}
+
+void FairnessMonitor::closeWindow(){
+	uint32_t progress[MAX_ID];
+
+	for (uint8_t w = 0; w < xWorkers; w++){
+		uint32_t loops = pWorkers[w]->getLoops();
+		progress[w] = loops - xWindowLoops[w];
+		xWindowLoops[w] = loops;
+	}
+	uint16_t fair = jain(progress, xWorkers);
+	xWindowFairSum += fair;
+	xWindows++;
+	if (fair < xWorstFair){
+		xWorstFair = fair;
+	}
+	TST_V.fairness = fair;
+
+	for (uint8_t w = 0; w < xWorkers; w++){
+		progress[w] = pWorkers[w]->getLoops() - xStartLoops[w];
+		TST_V.waitShare[w] = (uint16_t)((xReadySamples[w] * 1000) / xSamples);
+	}
+	TST_V.fairnessTotal = jain(progress, xWorkers);
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		TST_V.readyLen[c] = (uint16_t)((xWindowReadyLen[c] * 100) / xWindowSamples);
+		xWindowReadyLen[c] = 0;
+	}
+	xWindowSamples = 0;
+}
+
+uint32_t FairnessMonitor::runUs(uint8_t w){
+	uint8_t slot = pWorkers[w]->getSlot();
+	uint32_t us = 0;
+	if ((slot == AGENT_REGISTRY_NONE) || (slot + 1 >= TRACE_MAX_TASKS)){
+		return 0;
+	}
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		us += ulTraceGetResidentUs(slot + 1, c);
+	}
+	return us;
+}
+
+uint16_t FairnessMonitor::jain(const uint32_t *x, uint8_t n){
+	uint64_t sum = 0;
+	uint64_t sumSq = 0;
+	for (uint8_t i = 0; i < n; i++){
+		sum += x[i];
+		sumSq += (uint64_t)x[i] * x[i];
+	}
+	if (sumSq == 0){
+		return 1000;
+	}
+	return (uint16_t)((sum * sum * 1000) / (n * sumSq));
+}
+
+void FairnessMonitor::report(Counter *counter){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+	uint32_t progress[MAX_ID];
+
+	if (xMissed > 0){
+		text.add("Fairness missed ").addUnsigned(xMissed)
+			.add(" samples, more than ").addUnsigned(FAIRNESS_MAX_TASKS)
+			.add(" tasks\n\r");
+		counter->print(text.c_str());
+		text.clear();
+	}
+	if (xSamples == 0){
+		return;
+	}
+
+	for (uint8_t w = 0; w < xWorkers; w++){
+		progress[w] = pWorkers[w]->getLoops() - xStartLoops[w];
+	}
+	uint16_t total = jain(progress, xWorkers);
+	uint16_t mean = (xWindows > 0) ? (xWindowFairSum / xWindows) : total;
+
+	text.add("Fairness over ").addUnsigned(xSamples)
+		.add(" samples of ").addUnsigned(FAIRNESS_SAMPLE_MS).add(" ms\n\r");
+	counter->print(text.c_str());
+	text.clear();
+	text.add("Jain: run ").addFixed(total, 3)
+		.add(" window mean ").addFixed(mean, 3)
+		.add(" worst ").addFixed(xWorstFair, 3).add("\n\r");
+	counter->print(text.c_str());
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		uint32_t len = (xReadyLen[c] * 100) / xSamples;
+		text.clear();
+		text.add("Core ").addUnsigned(c).add(" ready length: ")
+			.addFixed(len, 2).add("\n\r");
+		counter->print(text.c_str());
+	}
+	uint32_t elapsedUs = time_us_32() - xStartUs;
+	counter->print("#\t+Runnable\t+Running\n\r");
+	for (uint8_t w = 0; w < xWorkers; w++){
+		uint32_t ready = (xReadySamples[w] * 1000) / xSamples;
+		uint32_t running = (elapsedUs > 0) ?
+				(uint32_t)(((uint64_t)(runUs(w) - xStartRunUs[w]) * 1000) / elapsedUs) : 0;
+		text.clear();
+		text.addUnsigned(w).add(":\t").addFixed(ready, 1)
+			.add("%\t\t").addFixed(running, 1).add("%\n\r");
+		counter->print(text.c_str());
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE FairnessMonitor::getMaxStackSize(){
+	return STACK_BUDGET(FairnessMonitor);
+}
@@ -0,0 +1,112 @@
+/*
+ * FairnessMonitor.h
+ *
+ * Follows Worker progress to judge how fairly the SMP scheduler shares
+ * the cores. Reports Jain's fairness index, ready list length per core
+ * and the share of time each worker was runnable but not running.
+ *
+ * Running time comes from the trace hook residency counters, so it is
+ * exact and costs nothing here. Ready state can only be seen with
+ * uxTaskGetSystemState, which suspends the scheduler and preempts the
+ * workers being measured, so it is sampled every FAIRNESS_SAMPLE_MS.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_FAIRNESSMONITOR_H_
+#define EXP_2CORERTOS_SRC_FAIRNESSMONITOR_H_
+
+#include "Agent.h"
+#include "Counter.h"
+#include "pico/stdlib.h"
+#include "traceHooks.h"
+extern "C"{
+#include "tst_variables.h"
+}
+
+#define FAIRNESS_SAMPLE_MS	100
+#define FAIRNESS_WINDOW		10		//Samples per fairness window
+//Every numbered task plus short lived ones that never get a number,
+//uxTaskGetSystemState returns nothing if there are more
+#define FAIRNESS_MAX_TASKS	(TRACE_MAX_TASKS + 4)
+
+class FairnessMonitor : public Agent {
+public:
+	FairnessMonitor();
+	virtual ~FairnessMonitor();
+
+	/***
+	 * Add a worker to watch
+	 * @param worker
+	 * @return false if MAX_ID workers are already watched
+	 */
+	bool addWorker(Agent *worker);
+
+	/***
+	 * Print end of run summary
+	 * @param counter - used for output
+	 */
+	void report(Counter *counter);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Take one sample of task states. Counted as missed, not as a
+	 * sample, if the task states could not be read.
+	 */
+	void sample();
+
+	/***
+	 * Close a window and publish to TST_V
+	 */
+	void closeWindow();
+
+	/***
+	 * Time the worker has run on either core
+	 * @param w - index of the worker
+	 * @return us
+	 */
+	uint32_t runUs(uint8_t w);
+
+	/***
+	 * Jain's fairness index of the values
+	 * @param x
+	 * @param n
+	 * @return per mille, 1000 is perfectly fair
+	 */
+	static uint16_t jain(const uint32_t *x, uint8_t n);
+
+	Agent *pWorkers[MAX_ID];
+	uint8_t xWorkers = 0;
+
+	TaskStatus_t xStatus[FAIRNESS_MAX_TASKS];
+
+	uint32_t xSamples = 0;
+	uint32_t xWindowSamples = 0;
+	uint32_t xMissed = 0;		//More tasks than FAIRNESS_MAX_TASKS
+
+	uint32_t xStartLoops[MAX_ID];
+	uint32_t xWindowLoops[MAX_ID];
+	uint32_t xReadySamples[MAX_ID];
+	uint32_t xStartRunUs[MAX_ID];
+	uint32_t xStartUs = 0;
+	uint32_t xReadyLen[MAX_CORES];
+	uint32_t xWindowReadyLen[MAX_CORES];
+	uint32_t xWindowFairSum = 0;
+	uint32_t xWindows = 0;
+	uint16_t xWorstFair = 1000;
+};
+
+#endif /* EXP_2CORERTOS_SRC_FAIRNESSMONITOR_H_ */
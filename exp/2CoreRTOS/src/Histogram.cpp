@@ -0,0 +1,102 @@
+/*
+ * Histogram.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "Histogram.h"
+
+Histogram::Histogram() {
+	reset();
+}
+
+Histogram::~Histogram() {
+	// NOP
+}
+
+void Histogram::record(uint32_t value){
+	uint16_t b = bucket(value);
+	xBuckets[b] = xBuckets[b] + 1;
+	if (value < xMin){
+		xMin = value;
+	}
+	if (value > xMax){
+		xMax = value;
+	}
+	xSum = xSum + value;
+	xCount = xCount + 1;
+}
+
+void Histogram::reset(){
+	for (uint16_t i = 0; i < HISTOGRAM_BUCKETS; i++){
+		xBuckets[i] = 0;
+	}
+	xCount = 0;
+	xMin = UINT32_MAX;
+	xMax = 0;
+	xSum = 0;
+}
+
+uint32_t Histogram::percentile(uint16_t perMille) const {
+	uint32_t count = xCount;
+	if (count == 0){
+		return 0;
+	}
+	//Rank of the sample wanted, rounding up so p99 of 10 is the max
+	uint32_t rank = (uint32_t)(((uint64_t)count * perMille + 999) / 1000);
+	if (rank == 0){
+		rank = 1;
+	}
+
+	uint32_t seen = 0;
+	for (uint16_t i = 0; i < HISTOGRAM_BUCKETS; i++){
+		seen += xBuckets[i];
+		if (seen >= rank){
+			uint32_t high = bucketHigh(i);
+			return (high < xMax) ? high : xMax;
+		}
+	}
+	return xMax;
+}
+
+uint32_t Histogram::getCount() const {
+	return xCount;
+}
+
+uint32_t Histogram::getMin() const {
+	return (xCount == 0) ? 0 : xMin;
+}
+
+uint32_t Histogram::getMax() const {
+	return xMax;
+}
+
+uint32_t Histogram::getMean() const {
+	uint32_t count = xCount;
+	if (count == 0){
+		return 0;
+	}
+	return (uint32_t)(xSum / count);
+}
+
+uint16_t Histogram::bucket(uint32_t value){
+	if (value < HISTOGRAM_SUB_COUNT){
+		return (uint16_t)value;
+	}
+	uint32_t exp = 31 - __builtin_clz(value);
+	uint32_t shift = exp - HISTOGRAM_SUB_BITS;
+	uint32_t sub = (value >> shift) & (HISTOGRAM_SUB_COUNT - 1);
+	return (uint16_t)((shift + 1) * HISTOGRAM_SUB_COUNT + sub);
+}
+
+uint32_t Histogram::bucketHigh(uint16_t bucket){
+	if (bucket < HISTOGRAM_SUB_COUNT){
+		return bucket;
+	}
+	uint32_t shift = (bucket / HISTOGRAM_SUB_COUNT) - 1;
+	uint32_t sub = bucket % HISTOGRAM_SUB_COUNT;
+	uint64_t low = (uint64_t)(HISTOGRAM_SUB_COUNT + sub) << shift;
+	uint64_t high = low + ((uint64_t)1 << shift) - 1;
+	return (high > UINT32_MAX) ? UINT32_MAX : (uint32_t)high;
+}
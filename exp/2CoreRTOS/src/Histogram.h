@@ -0,0 +1,80 @@
+/*
+ * Histogram.h
+ *
+ * Fixed size log bucketed histogram, in the style of HDR histograms.
+ * Values below HISTOGRAM_SUB_COUNT are exact, above that each power of
+ * two is split into HISTOGRAM_SUB_COUNT buckets, so a reported value
+ * is within 1/HISTOGRAM_SUB_COUNT of the true one.
+ *
+ * There are no locks. Only one context may record, any context may
+ * read and will see a slightly stale but usable view.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_HISTOGRAM_H_
+#define EXP_2CORERTOS_SRC_HISTOGRAM_H_
+
+#include <cstdint>
+
+#define HISTOGRAM_SUB_BITS		3
+#define HISTOGRAM_SUB_COUNT		(1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS		((32 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT)
+
+class Histogram {
+public:
+	Histogram();
+	virtual ~Histogram();
+
+	/***
+	 * Record one value. Single writer only.
+	 * @param value
+	 */
+	void record(uint32_t value);
+
+	/***
+	 * Clear all counts. Must not race with record.
+	 */
+	void reset();
+
+	/***
+	 * Value at or below which the given share of samples fall
+	 * @param perMille - 500 for median, 990 for p99
+	 * @return upper bound of the bucket, 0 if empty
+	 */
+	uint32_t percentile(uint16_t perMille) const;
+
+	uint32_t getCount() const;
+	uint32_t getMin() const;
+	uint32_t getMax() const;
+
+	/***
+	 * Mean of the recorded values
+	 * @return 0 if empty
+	 */
+	uint32_t getMean() const;
+
+	/***
+	 * Bucket a value falls in
+	 * @param value
+	 * @return 0 to HISTOGRAM_BUCKETS - 1
+	 */
+	static uint16_t bucket(uint32_t value);
+
+	/***
+	 * Largest value that falls in a bucket
+	 * @param bucket
+	 * @return
+	 */
+	static uint32_t bucketHigh(uint16_t bucket);
+
+private:
+	volatile uint32_t xBuckets[HISTOGRAM_BUCKETS];
+	volatile uint32_t xCount = 0;
+	volatile uint32_t xMin = UINT32_MAX;
+	volatile uint32_t xMax = 0;
+	volatile uint64_t xSum = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_HISTOGRAM_H_ */
@@ -0,0 +1,127 @@
+/*
+ * InplaceFunction.h
+ *
+ * Small buffer callable wrapper. Behaves like std::function but the
+ * callable is always stored inside the object, so it never allocates.
+ * Callables that do not fit are rejected at compile time.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_INPLACEFUNCTION_H_
+#define EXP_2CORERTOS_SRC_INPLACEFUNCTION_H_
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+template<typename Signature, size_t Capacity = 32>
+class InplaceFunction;
+
+template<typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+	/***
+	 * Constructor - empty callable
+	 */
+	InplaceFunction() = default;
+
+	/***
+	 * Constructor - store callable in place
+	 * @param f - callable, must fit within Capacity bytes
+	 */
+	template<typename F,
+		typename = std::enable_if_t<
+			!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+	InplaceFunction(F &&f){
+		typedef std::decay_t<F> Fn;
+		static_assert(sizeof(Fn) <= Capacity,
+				"Callable too large for InplaceFunction buffer");
+		static_assert(alignof(Fn) <= alignof(std::max_align_t),
+				"Callable alignment not supported");
+		new (xStorage) Fn(std::forward<F>(f));
+		pInvoke = &invoke<Fn>;
+		pManage = &manage<Fn>;
+	}
+
+	InplaceFunction(const InplaceFunction &other){
+		copyFrom(other);
+	}
+
+	InplaceFunction & operator=(const InplaceFunction &other){
+		if (this != &other){
+			reset();
+			copyFrom(other);
+		}
+		return *this;
+	}
+
+	/***
+	 * Destructor
+	 */
+	~InplaceFunction(){
+		reset();
+	}
+
+	/***
+	 * Call the stored callable
+	 */
+	R operator()(Args... args){
+		return pInvoke(xStorage, std::forward<Args>(args)...);
+	}
+
+	/***
+	 * Is a callable held
+	 */
+	explicit operator bool() const {
+		return pInvoke != nullptr;
+	}
+
+	/***
+	 * Destroy the held callable
+	 */
+	void reset(){
+		if (pManage != nullptr){
+			pManage(xStorage, nullptr);
+		}
+		pInvoke = nullptr;
+		pManage = nullptr;
+	}
+
+private:
+	typedef R (*Invoker)(void *, Args&&...);
+	typedef void (*Manager)(void *dst, const void *src);
+
+	template<typename Fn>
+	static R invoke(void *storage, Args&&... args){
+		return (*static_cast<Fn *>(storage))(std::forward<Args>(args)...);
+	}
+
+	/***
+	 * Copy construct into dst from src, or destroy dst when src is NULL
+	 */
+	template<typename Fn>
+	static void manage(void *dst, const void *src){
+		if (src == nullptr){
+			static_cast<Fn *>(dst)->~Fn();
+		} else {
+			new (dst) Fn(*static_cast<const Fn *>(src));
+		}
+	}
+
+	void copyFrom(const InplaceFunction &other){
+		if (other.pManage != nullptr){
+			other.pManage(xStorage, other.xStorage);
+		}
+		pInvoke = other.pInvoke;
+		pManage = other.pManage;
+	}
+
+	alignas(std::max_align_t) unsigned char xStorage[Capacity];
+	Invoker pInvoke = nullptr;
+	Manager pManage = nullptr;
+};
+
+#endif /* EXP_2CORERTOS_SRC_INPLACEFUNCTION_H_ */
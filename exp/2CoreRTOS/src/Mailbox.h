@@ -0,0 +1,196 @@
+/*
+ * Mailbox.h
+ *
+ * Bounded queue of pooled messages owned by one Agent. Any task,
+ * on either core, or an interrupt may post. Only the owning Agent
+ * receives. Posting moves the MessagePtr in, so the payload is never
+ * copied, and wakes the owner if it is waiting.
+ *
+ * Lock free: posters claim a cell with compare and swap, each cell
+ * carries a sequence number that says whose turn it is.
+ *
+ * Messages still queued when the mailbox is destroyed go back to their
+ * pools, so a pool must outlive every mailbox its messages are in.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_MAILBOX_H_
+#define EXP_2CORERTOS_SRC_MAILBOX_H_
+
+#include "Agent.h"
+#include "MessagePool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template<typename T, size_t N>
+class Mailbox {
+public:
+	static_assert((N & (N - 1)) == 0, "Mailbox length must be a power of two");
+
+	/***
+	 * Constructor
+	 * @param owner - Agent that receives from this mailbox
+	 */
+	Mailbox(Agent *owner){
+		pOwner = owner;
+		for (size_t i = 0; i < N; i++){
+			xCells[i].xSeq.store((uint32_t)i, std::memory_order_relaxed);
+		}
+	}
+
+	/***
+	 * Destructor, returns queued messages to their pools
+	 */
+	~Mailbox(){
+		while (tryReceive()){
+			// Released as each MessagePtr goes
+		}
+	}
+
+	/***
+	 * Post a message. On success msg is left empty.
+	 * @param msg
+	 * @return false if full, msg is still owned by the caller
+	 */
+	bool post(MessagePtr<T> &msg){
+		if (!enqueue(msg)){
+			return false;
+		}
+		pOwner->notifyMail();
+		return true;
+	}
+
+	/***
+	 * Post from an interrupt
+	 * @param msg
+	 * @param pxHigherPriorityTaskWoken - set if a yield is needed
+	 * @return false if full, msg is still owned by the caller
+	 */
+	bool postFromISR(MessagePtr<T> &msg, BaseType_t *pxHigherPriorityTaskWoken){
+		if (!enqueue(msg)){
+			return false;
+		}
+		pOwner->notifyMailFromISR(pxHigherPriorityTaskWoken);
+		return true;
+	}
+
+	/***
+	 * Take the next message without waiting. Owner only.
+	 * @return empty MessagePtr if there is none
+	 */
+	MessagePtr<T> tryReceive(){
+		uint32_t pos = xDequeue.load(std::memory_order_relaxed);
+		Cell *cell = &xCells[pos & (N - 1)];
+		uint32_t seq = cell->xSeq.load(std::memory_order_acquire);
+		if ((int32_t)(seq - (pos + 1)) < 0){
+			return MessagePtr<T>();
+		}
+		MessagePtr<T> msg(cell->pMsg, cell->pSource);
+		cell->xSeq.store(pos + N, std::memory_order_release);
+		xDequeue.store(pos + 1, std::memory_order_relaxed);
+		return msg;
+	}
+
+	/***
+	 * Take the next message, waiting for one to be posted. Owner only.
+	 * @param ticks - maximum wait
+	 * @return empty MessagePtr on timeout or stop request
+	 */
+	MessagePtr<T> receive(TickType_t ticks = portMAX_DELAY){
+		TimeOut_t timeOut;
+		vTaskSetTimeOutState(&timeOut);
+		for (;;){
+			MessagePtr<T> msg = tryReceive();
+			if (msg){
+				return msg;
+			}
+			//Notifications can be left over from mail already taken
+			if (xTaskCheckForTimeOut(&timeOut, &ticks) != pdFALSE){
+				return msg;
+			}
+			if (pOwner->waitMail(ticks)){
+				return msg;
+			}
+		}
+	}
+
+	/***
+	 * Messages waiting, may be stale by the time it is used
+	 * @return
+	 */
+	uint32_t size() const {
+		return xEnqueue.load(std::memory_order_relaxed) -
+				xDequeue.load(std::memory_order_relaxed);
+	}
+
+	/***
+	 * Most messages seen waiting at once
+	 * @return
+	 */
+	uint32_t highWater() const {
+		return xHighWater;
+	}
+
+	/***
+	 * Number of posts refused because the mailbox was full
+	 * @return
+	 */
+	uint32_t getRejected() const {
+		return xRejected.load(std::memory_order_relaxed);
+	}
+
+	constexpr size_t capacity() const {
+		return N;
+	}
+
+private:
+	struct Cell {
+		std::atomic<uint32_t> xSeq;
+		T *pMsg = nullptr;
+		MessageSource<T> *pSource = nullptr;
+	};
+
+	bool enqueue(MessagePtr<T> &msg){
+		if (!msg){
+			return false;
+		}
+		uint32_t pos = xEnqueue.load(std::memory_order_relaxed);
+		Cell *cell;
+		for (;;){
+			cell = &xCells[pos & (N - 1)];
+			uint32_t seq = cell->xSeq.load(std::memory_order_acquire);
+			int32_t diff = (int32_t)(seq - pos);
+			if (diff == 0){
+				if (xEnqueue.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed)){
+					break;
+				}
+			} else if (diff < 0){
+				xRejected.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			} else {
+				pos = xEnqueue.load(std::memory_order_relaxed);
+			}
+		}
+		cell->pMsg = msg.detach(&cell->pSource);
+		cell->xSeq.store(pos + 1, std::memory_order_release);
+
+		uint32_t depth = pos + 1 - xDequeue.load(std::memory_order_relaxed);
+		if (depth > xHighWater){
+			xHighWater = depth;
+		}
+		return true;
+	}
+
+	Agent *pOwner;
+	Cell xCells[N];
+	std::atomic<uint32_t> xEnqueue {0};
+	std::atomic<uint32_t> xDequeue {0};
+	std::atomic<uint32_t> xRejected {0};
+	uint32_t xHighWater = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_MAILBOX_H_ */
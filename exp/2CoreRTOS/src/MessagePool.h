@@ -0,0 +1,220 @@
+/*
+ * MessagePool.h
+ *
+ * Fixed pool of messages handed between Agents by pointer. A
+ * MessagePtr owns one message and gives it back to its pool when it
+ * is destroyed or reset, so a consumer never frees by hand.
+ *
+ * Allocation and release are lock free, using a tagged free list, so
+ * may be used from either core or an interrupt. Messages are not
+ * cleared between uses, the producer must fill every field.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_MESSAGEPOOL_H_
+#define EXP_2CORERTOS_SRC_MESSAGEPOOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#define MESSAGE_POOL_EMPTY	0xFFFF	//Free list end marker
+
+/***
+ * Where a message goes back to when its owner is done with it
+ */
+template<typename T>
+class MessageSource {
+public:
+	virtual ~MessageSource() = default;
+	virtual void release(T *msg) = 0;
+};
+
+
+/***
+ * Owning, move only, pointer to a pooled message
+ */
+template<typename T>
+class MessagePtr {
+public:
+	MessagePtr() = default;
+
+	MessagePtr(T *msg, MessageSource<T> *source){
+		pMsg = msg;
+		pSource = source;
+	}
+
+	MessagePtr(MessagePtr &&other){
+		pMsg = other.pMsg;
+		pSource = other.pSource;
+		other.pMsg = nullptr;
+		other.pSource = nullptr;
+	}
+
+	MessagePtr &operator=(MessagePtr &&other){
+		if (this != &other){
+			reset();
+			pMsg = other.pMsg;
+			pSource = other.pSource;
+			other.pMsg = nullptr;
+			other.pSource = nullptr;
+		}
+		return *this;
+	}
+
+	MessagePtr(const MessagePtr &) = delete;
+	MessagePtr &operator=(const MessagePtr &) = delete;
+
+	~MessagePtr(){
+		reset();
+	}
+
+	/***
+	 * Give the message back to its pool now
+	 */
+	void reset(){
+		if (pMsg != nullptr){
+			pSource->release(pMsg);
+			pMsg = nullptr;
+			pSource = nullptr;
+		}
+	}
+
+	/***
+	 * Give up ownership without releasing, used by Mailbox
+	 * @param source - set to the pool the message must return to
+	 * @return message
+	 */
+	T *detach(MessageSource<T> **source){
+		T *msg = pMsg;
+		*source = pSource;
+		pMsg = nullptr;
+		pSource = nullptr;
+		return msg;
+	}
+
+	T *get() const {
+		return pMsg;
+	}
+
+	T *operator->() const {
+		return pMsg;
+	}
+
+	T &operator*() const {
+		return *pMsg;
+	}
+
+	explicit operator bool() const {
+		return pMsg != nullptr;
+	}
+
+private:
+	T *pMsg = nullptr;
+	MessageSource<T> *pSource = nullptr;
+};
+
+
+template<typename T, size_t N>
+class MessagePool : public MessageSource<T> {
+public:
+	static_assert(N < MESSAGE_POOL_EMPTY, "MessagePool too large");
+
+	MessagePool(){
+		for (size_t i = 0; i < N; i++){
+			xNext[i].store((i + 1 < N) ? (uint16_t)(i + 1) : MESSAGE_POOL_EMPTY,
+					std::memory_order_relaxed);
+		}
+		xHead.store(0, std::memory_order_relaxed);
+	}
+
+	/***
+	 * Take a message from the pool
+	 * @return empty MessagePtr if the pool is exhausted
+	 */
+	MessagePtr<T> alloc(){
+		uint32_t head = xHead.load(std::memory_order_acquire);
+		for (;;){
+			uint16_t index = (uint16_t)(head & 0xFFFF);
+			if (index == MESSAGE_POOL_EMPTY){
+				xExhausted.fetch_add(1, std::memory_order_relaxed);
+				return MessagePtr<T>();
+			}
+			uint16_t next = xNext[index].load(std::memory_order_relaxed);
+			uint32_t swap = tag(head) | next;
+			if (xHead.compare_exchange_weak(head, swap,
+					std::memory_order_acq_rel, std::memory_order_acquire)){
+				uint32_t used = xUsed.fetch_add(1, std::memory_order_relaxed) + 1;
+				if (used > xHighWater){
+					xHighWater = used;
+				}
+				return MessagePtr<T>(&xSlots[index], this);
+			}
+		}
+	}
+
+	/***
+	 * Return a message, normally called by MessagePtr
+	 * @param msg
+	 */
+	virtual void release(T *msg){
+		uint16_t index = (uint16_t)(msg - xSlots);
+		uint32_t head = xHead.load(std::memory_order_acquire);
+		for (;;){
+			xNext[index].store((uint16_t)(head & 0xFFFF), std::memory_order_relaxed);
+			uint32_t swap = tag(head) | index;
+			if (xHead.compare_exchange_weak(head, swap,
+					std::memory_order_acq_rel, std::memory_order_acquire)){
+				break;
+			}
+		}
+		xUsed.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	/***
+	 * Messages currently free
+	 * @return
+	 */
+	uint32_t available() const {
+		return N - xUsed.load(std::memory_order_relaxed);
+	}
+
+	/***
+	 * Most messages ever in use at once
+	 * @return
+	 */
+	uint32_t highWater() const {
+		return xHighWater;
+	}
+
+	/***
+	 * Number of times alloc found the pool empty
+	 * @return
+	 */
+	uint32_t getExhausted() const {
+		return xExhausted.load(std::memory_order_relaxed);
+	}
+
+	constexpr size_t capacity() const {
+		return N;
+	}
+
+private:
+	/***
+	 * Next ABA tag for a head value, in the top 16 bits
+	 */
+	static uint32_t tag(uint32_t head){
+		return (head + 0x10000) & 0xFFFF0000;
+	}
+
+	T xSlots[N];
+	std::atomic<uint16_t> xNext[N];
+	std::atomic<uint32_t> xHead;
+	std::atomic<uint32_t> xUsed {0};
+	std::atomic<uint32_t> xExhausted {0};
+	uint32_t xHighWater = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_MESSAGEPOOL_H_ */
@@ -0,0 +1,185 @@
+/*
+ * MetricRegistry.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "MetricRegistry.h"
+
+MetricRegistry *MetricRegistry::pSingleton = NULL;
+
+MetricRegistry::MetricRegistry() {
+	for (uint8_t i = 0; i < METRICS_MAX; i++){
+		xMetrics[i].pName = NULL;
+		xMetrics[i].xType = METRIC_NONE;
+		xMetrics[i].xSlot = 0;
+		xMetrics[i].xIndex = 0;
+		xMetrics[i].pMetric = NULL;
+	}
+}
+
+MetricRegistry::~MetricRegistry() {
+	// NOP
+}
+
+MetricRegistry * MetricRegistry::getInstance(){
+	if (MetricRegistry::pSingleton == NULL){
+		MetricRegistry::pSingleton = new MetricRegistry;
+	}
+	return MetricRegistry::pSingleton;
+}
+
+MetricCounter *MetricRegistry::counter(const char *name){
+	return create(name, METRIC_COUNTER, xCounters,
+			&xCounterCount, METRICS_MAX_COUNTERS, 1);
+}
+
+MetricGauge *MetricRegistry::gauge(const char *name){
+	return create(name, METRIC_GAUGE, xGauges,
+			&xGaugeCount, METRICS_MAX_GAUGES, 1);
+}
+
+Histogram *MetricRegistry::histogram(const char *name){
+	return create(name, METRIC_HISTOGRAM, xHistograms,
+			&xHistogramCount, METRICS_MAX_HISTOGRAMS, METRIC_HISTOGRAM_SLOTS);
+}
+
+bool MetricRegistry::counter(const char *name, const MetricSource *source, uint8_t index){
+	return add(name, METRIC_SOURCE, (void *)source, 1, index);
+}
+
+uint8_t MetricRegistry::claim(volatile uint8_t *used, uint8_t max, uint8_t n){
+	uint8_t first = *used;
+	do {
+		if ((uint16_t)first + n > max){
+			return max;
+		}
+	} while (!__atomic_compare_exchange_n(used, &first, (uint8_t)(first + n),
+			false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+	return first;
+}
+
+void MetricRegistry::release(volatile uint8_t *used, uint8_t first, uint8_t n){
+	uint8_t last = first + n;
+	__atomic_compare_exchange_n(used, &last, first,
+			false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+bool MetricRegistry::add(const char *name, MetricType type, void *metric, uint8_t slots,
+		uint8_t index){
+	uint8_t i = claim(&xCount, METRICS_MAX);
+	if (i >= METRICS_MAX){
+		return false;
+	}
+	uint8_t slot = claim(&xSlots, UINT8_MAX, slots);
+	if (slot == UINT8_MAX){
+		//Left as METRIC_NONE, readers skip it if it cannot be handed back
+		release(&xCount, i);
+		return false;
+	}
+	Metric &m = xMetrics[i];
+	m.pName = name;
+	m.xSlot = slot;
+	m.xIndex = index;
+	m.pMetric = metric;
+	//Readers skip the entry until the type says it is complete
+	__dmb();
+	m.xType = type;
+	return true;
+}
+
+uint8_t MetricRegistry::getCount(){
+	return xCount;
+}
+
+const MetricRegistry::Metric *MetricRegistry::get(uint8_t index){
+	if (index >= xCount){
+		return NULL;
+	}
+	const Metric *m = &xMetrics[index];
+	if (m->xType == METRIC_NONE){
+		return NULL;
+	}
+	__dmb();
+	return m;
+}
+
+uint8_t MetricRegistry::getSlots(){
+	return xSlots;
+}
+
+uint8_t MetricRegistry::read(uint8_t first, uint32_t *values, uint8_t max){
+	uint8_t slots = xSlots;
+	if (first >= slots){
+		return 0;
+	}
+	uint8_t n = slots - first;
+	if (n > max){
+		n = max;
+	}
+	for (uint8_t i = 0; i < n; i++){
+		values[i] = 0;
+	}
+
+	//Each metric fills in whichever of its slots fall in the range
+	uint8_t count = xCount;
+	for (uint8_t i = 0; i < count; i++){
+		const Metric *m = get(i);
+		if (m == NULL){
+			continue;
+		}
+		uint8_t width = (m->xType == METRIC_HISTOGRAM) ? METRIC_HISTOGRAM_SLOTS : 1;
+		for (uint8_t part = 0; part < width; part++){
+			uint8_t slot = m->xSlot + part;
+			if ((slot >= first) && (slot < first + n)){
+				values[slot - first] = value(m, part);
+			}
+		}
+	}
+	return n;
+}
+
+uint32_t MetricRegistry::value(const Metric *metric, uint8_t part){
+	switch (metric->xType){
+	case METRIC_COUNTER:
+		return ((MetricCounter *)metric->pMetric)->get();
+	case METRIC_GAUGE:
+		return (uint32_t)((MetricGauge *)metric->pMetric)->get();
+	case METRIC_SOURCE:
+		return ((const MetricSource *)metric->pMetric)->read(metric->xIndex);
+	case METRIC_HISTOGRAM: {
+		Histogram *hist = (Histogram *)metric->pMetric;
+		switch (part){
+		case 0:
+			return hist->getCount();
+		case 1:
+			return hist->getMin();
+		case 2:
+			return hist->percentile(500);
+		case 3:
+			return hist->percentile(900);
+		case 4:
+			return hist->percentile(990);
+		default:
+			return hist->getMax();
+		}
+	}
+	default:
+		return 0;
+	}
+}
+
+const char *MetricRegistry::typeName(uint8_t type){
+	switch (type){
+	case METRIC_COUNTER:
+	case METRIC_SOURCE:
+		return "counter";
+	case METRIC_GAUGE:
+		return "gauge";
+	case METRIC_HISTOGRAM:
+		return "histogram";
+	default:
+		return "none";
+	}
+}
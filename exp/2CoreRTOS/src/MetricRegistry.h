@@ -0,0 +1,254 @@
+/*
+ * MetricRegistry.h
+ *
+ * Named counters, gauges and histograms in a fixed arena. Modules
+ * register what they measure at startup and keep the returned pointer,
+ * TSTMetrics then publishes every registered metric over TST
+ * without either side knowing about the other.
+ *
+ * Registration and updates take no locks. Names must be string
+ * literals or otherwise outlive the registry.
+ *
+ * Counts that have to be read together, such as the job counts by id
+ * and by core, stay in their own structure and are exported through a
+ * MetricSource so the module keeps its consistent snapshot.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_METRICREGISTRY_H_
+#define EXP_2CORERTOS_SRC_METRICREGISTRY_H_
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "Histogram.h"
+
+#define METRICS_MAX				80
+#define METRICS_MAX_COUNTERS	16
+#define METRICS_MAX_GAUGES		56		//CpuMonitor takes two per task
+#define METRICS_MAX_HISTOGRAMS	8
+#define METRICS_CORES			2
+#define METRIC_HISTOGRAM_SLOTS	6		//count, min, p50, p90, p99, max
+
+enum MetricType {
+	METRIC_NONE = 0,
+	METRIC_COUNTER,
+	METRIC_GAUGE,
+	METRIC_HISTOGRAM,
+	METRIC_SOURCE		//Counter read through a MetricSource
+};
+
+/***
+ * Counts kept by a module, read by index. Exported as counters.
+ */
+class MetricSource {
+public:
+	virtual ~MetricSource() {}
+
+	/***
+	 * Current value of one count
+	 * @param index - as registered
+	 * @return
+	 */
+	virtual uint32_t read(uint8_t index) const = 0;
+};
+
+/***
+ * Event count. Each core adds to its own slot so increments from both
+ * cores never contend or get lost.
+ */
+class MetricCounter {
+public:
+	void inc(){
+		add(1);
+	}
+
+	void add(uint32_t n){
+		uint32_t irq = save_and_disable_interrupts();
+		uint8_t core = get_core_num();
+		if (core < METRICS_CORES){
+			xCores[core] = xCores[core] + n;
+		}
+		restore_interrupts(irq);
+	}
+
+	uint32_t get() const {
+		uint32_t sum = 0;
+		for (uint8_t c = 0; c < METRICS_CORES; c++){
+			sum += xCores[c];
+		}
+		return sum;
+	}
+
+private:
+	volatile uint32_t xCores[METRICS_CORES] = {0};
+};
+
+/***
+ * Latest value of something
+ */
+class MetricGauge {
+public:
+	void set(int32_t value){
+		xValue = value;
+	}
+
+	void add(int32_t delta){
+		__atomic_fetch_add(&xValue, delta, __ATOMIC_RELAXED);
+	}
+
+	int32_t get() const {
+		return xValue;
+	}
+
+private:
+	volatile int32_t xValue = 0;
+};
+
+class MetricRegistry {
+public:
+	/***
+	 * Registered metric
+	 */
+	struct Metric {
+		const char *pName;
+		volatile uint8_t xType;		//MetricType, set last once usable
+		uint8_t xSlot;				//First export slot
+		uint8_t xIndex;				//Count within a MetricSource
+		void *pMetric;
+	};
+
+	static MetricRegistry * getInstance();
+
+	/***
+	 * Register a metric. Names are not checked for duplicates.
+	 * @param name
+	 * @return NULL if the arena for that type is full
+	 */
+	MetricCounter *counter(const char *name);
+	MetricGauge *gauge(const char *name);
+	Histogram *histogram(const char *name);
+
+	/***
+	 * Register a count kept by a MetricSource, exported as a counter
+	 * @param name
+	 * @param source - must outlive the registry
+	 * @param index - passed to source->read
+	 * @return false if the registry is full
+	 */
+	bool counter(const char *name, const MetricSource *source, uint8_t index);
+
+	/***
+	 * Number of metrics registered
+	 * @return
+	 */
+	uint8_t getCount();
+
+	/***
+	 * Metric by registration order
+	 * @param index
+	 * @return NULL if out of range or still being registered
+	 */
+	const Metric *get(uint8_t index);
+
+	/***
+	 * Number of 32 bit export slots in use. Counters and gauges take
+	 * one, histograms METRIC_HISTOGRAM_SLOTS.
+	 * @return
+	 */
+	uint8_t getSlots();
+
+	/***
+	 * Current values of a run of export slots
+	 * @param first - slot to start from
+	 * @param values - filled in
+	 * @param max - size of values
+	 * @return number of values written
+	 */
+	uint8_t read(uint8_t first, uint32_t *values, uint8_t max);
+
+	/***
+	 * Short name of a type for descriptors and reports
+	 * @param type
+	 * @return
+	 */
+	static const char *typeName(uint8_t type);
+
+protected:
+	MetricRegistry();
+	virtual ~MetricRegistry();
+
+private:
+	/***
+	 * Claim the next entry and its export slots, the entry first so a
+	 * full registry claims nothing
+	 * @param name
+	 * @param type
+	 * @param metric - storage in the typed arena
+	 * @param slots
+	 * @param index - count within a MetricSource
+	 * @return false if out of entries or slots
+	 */
+	bool add(const char *name, MetricType type, void *metric, uint8_t slots,
+			uint8_t index = 0);
+
+	/***
+	 * Take the next free entries of a pool without a lock
+	 * @param used - pool count, updated
+	 * @param max
+	 * @param n - entries wanted
+	 * @return first entry, max if the pool is too full
+	 */
+	static uint8_t claim(volatile uint8_t *used, uint8_t max, uint8_t n = 1);
+
+	/***
+	 * Hand back entries from claim when the registration failed. Only
+	 * possible while they are still the last claimed, otherwise they
+	 * stay claimed and unused.
+	 * @param used - pool count, updated
+	 * @param first - from claim
+	 * @param n - entries claimed
+	 */
+	static void release(volatile uint8_t *used, uint8_t first, uint8_t n = 1);
+
+	/***
+	 * Read the value in one slot of a metric
+	 * @param metric
+	 * @param part - slot offset within the metric
+	 * @return
+	 */
+	static uint32_t value(const Metric *metric, uint8_t part);
+
+	static MetricRegistry *pSingleton;
+
+	/***
+	 * Take a typed entry and register it
+	 */
+	template<typename T>
+	T *create(const char *name, MetricType type, T *pool,
+			volatile uint8_t *used, uint8_t max, uint8_t slots){
+		uint8_t i = claim(used, max);
+		if (i >= max){
+			return NULL;
+		}
+		if (!add(name, type, &pool[i], slots)){
+			release(used, i);
+			return NULL;
+		}
+		return &pool[i];
+	}
+
+	Metric xMetrics[METRICS_MAX];
+	volatile uint8_t xCount = 0;
+	volatile uint8_t xSlots = 0;
+
+	MetricCounter xCounters[METRICS_MAX_COUNTERS];
+	MetricGauge xGauges[METRICS_MAX_GAUGES];
+	Histogram xHistograms[METRICS_MAX_HISTOGRAMS];
+	volatile uint8_t xCounterCount = 0;
+	volatile uint8_t xGaugeCount = 0;
+	volatile uint8_t xHistogramCount = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_METRICREGISTRY_H_ */
@@ -0,0 +1,177 @@
+/*
+ * MigrationMonitor.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "MigrationMonitor.h"
+#include "TextBuffer.h"
+
+MigrationMonitor::MigrationMonitor() {
+	for (uint8_t t = 0; t < TRACE_MAX_TASKS; t++){
+		xLastMigrations[t] = 0;
+		xStartMigrations[t] = 0;
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			xLastResidentUs[t][c] = 0;
+			xStartResidentUs[t][c] = 0;
+		}
+	}
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xLogTail[c] = 0;
+	}
+}
+
+MigrationMonitor::~MigrationMonitor() {
+	stop();
+}
+
+/***
+ * Task main run loop
+ */
+void MigrationMonitor::run(){
+	//Only report what happens from now on
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xLogTail[c] = ulTraceLogHead[c];
+	}
+	for (uint8_t t = 0; t < TRACE_MAX_TASKS; t++){
+		xStartMigrations[t] = xTraceTasks[t].ulMigrations;
+		xLastMigrations[t] = xStartMigrations[t];
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			xStartResidentUs[t][c] = ulTraceGetResidentUs(t, c);
+			xLastResidentUs[t][c] = xStartResidentUs[t][c];
+		}
+	}
+	xStartUs = time_us_64();
+
+	uint64_t last = xStartUs;
+	while (!delayOrStop(pdMS_TO_TICKS(MIGRATION_PERIOD_MS))){
+		heartbeat();
+		uint64_t now = time_us_64();
+		sample(now - last);
+		logEvents();
+		last = now;
+	}
+}
+
+void MigrationMonitor::sample(uint64_t elapsedUs){
+	uint32_t total = 0;
+
+	for (uint8_t t = 1; t < TRACE_MAX_TASKS; t++){
+		uint32_t migrations = xTraceTasks[t].ulMigrations;
+		total += migrations;
+
+		uint8_t slot = t - 1;
+		if (slot >= TST_MAX_AGENTS){
+			continue;
+		}
+
+		TST_V.migRate[slot] = (uint16_t)(
+				((uint64_t)(migrations - xLastMigrations[t]) * 1000000) / elapsedUs);
+		xLastMigrations[t] = migrations;
+
+		uint32_t resident[MAX_CORES];
+		uint32_t sum = 0;
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			uint32_t us = ulTraceGetResidentUs(t, c);
+			resident[c] = us - xLastResidentUs[t][c];
+			xLastResidentUs[t][c] = us;
+			sum += resident[c];
+		}
+		TST_V.core1Share[slot] = (sum > 0) ?
+				(uint8_t)(((uint64_t)resident[1] * 100) / sum) : 0;
+	}
+	TST_V.migrations = total;
+}
+
+void MigrationMonitor::logEvents(){
+	char line[48];
+	TextBuffer text(line, sizeof(line));
+	uint8_t sent = 0;
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		uint32_t head = ulTraceLogHead[c];
+		uint32_t tail = xLogTail[c];
+
+		//Ring overwritten before we got to it
+		if ((head - tail) > TRACE_LOG_LEN){
+			xDropped += (head - tail) - TRACE_LOG_LEN;
+			tail = head - TRACE_LOG_LEN;
+		}
+
+		for (; tail != head; tail++){
+			if (sent >= MIGRATION_LOG_PER_SEC){
+				xDropped++;
+				continue;
+			}
+			volatile TraceMigration_t *event = &xTraceLog[c][tail & (TRACE_LOG_LEN - 1)];
+			text.clear();
+			text.add("Mig ").addUnsigned(event->ulTimeUs)
+				.add(' ').add(taskName(event->ucTaskNumber))
+				.add(' ').addUnsigned(event->ucFrom)
+				.add('>').addUnsigned(event->ucTo);
+			tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+			sent++;
+			xLogged++;
+		}
+		xLogTail[c] = head;
+	}
+}
+
+const char * MigrationMonitor::taskName(uint8_t taskNumber){
+	Agent *agent = AgentRegistry::getAgent(taskNumber - 1);
+	if (agent == NULL){
+		return "?";
+	}
+	return agent->getName();
+}
+
+void MigrationMonitor::report(Counter *counter){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+	uint64_t ms = (time_us_64() - xStartUs) / 1000;
+
+	if (ms == 0){
+		return;
+	}
+
+	text.add("Migrations over ").addUnsigned(ms)
+		.add(" ms, ").addUnsigned(xLogged)
+		.add(" logged ").addUnsigned(xDropped).add(" dropped\n\r");
+	counter->print(text.c_str());
+	counter->print("Agent\t\t+Moves\t+Per sec\t+Core 0\t+Core 1\n\r");
+
+	uint8_t slots = AgentRegistry::getSlots();
+	for (uint8_t slot = 0; (slot < slots) && (slot + 1 < TRACE_MAX_TASKS); slot++){
+		Agent *agent = AgentRegistry::getAgent(slot);
+		if (agent == NULL){
+			continue;
+		}
+		uint8_t t = slot + 1;
+		uint32_t moves = xTraceTasks[t].ulMigrations - xStartMigrations[t];
+		uint32_t rate = (uint32_t)(((uint64_t)moves * 100000) / ms);
+		uint32_t resident[MAX_CORES];
+		uint64_t sum = 0;
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			resident[c] = ulTraceGetResidentUs(t, c) - xStartResidentUs[t][c];
+			sum += resident[c];
+		}
+		uint32_t core0 = (sum > 0) ? (uint32_t)((resident[0] * 1000ULL) / sum) : 0;
+		uint32_t core1 = (sum > 0) ? (uint32_t)((resident[1] * 1000ULL) / sum) : 0;
+		text.clear();
+		text.add(agent->getName(), 15)
+			.add('\t').addUnsigned(moves)
+			.add('\t').addFixed(rate, 2)
+			.add("\t\t").addFixed(core0, 1)
+			.add("%\t").addFixed(core1, 1).add("%\n\r");
+		counter->print(text.c_str());
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE MigrationMonitor::getMaxStackSize(){
+	return STACK_BUDGET(MigrationMonitor);
+}
@@ -0,0 +1,78 @@
+/*
+ * MigrationMonitor.h
+ *
+ * Follows Agents between cores using the scheduler trace hooks.
+ * Publishes migrations per second and core residency for each Agent,
+ * and logs individual migrations to the TST monitor, rate limited.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_MIGRATIONMONITOR_H_
+#define EXP_2CORERTOS_SRC_MIGRATIONMONITOR_H_
+
+#include "Agent.h"
+#include "AgentRegistry.h"
+#include "Counter.h"
+#include "pico/stdlib.h"
+extern "C"{
+#include "tst_variables.h"
+}
+
+#define MIGRATION_PERIOD_MS		1000
+#define MIGRATION_LOG_PER_SEC	4		//Events sent to the monitor each period
+
+class MigrationMonitor : public Agent {
+public:
+	MigrationMonitor();
+	virtual ~MigrationMonitor();
+
+	/***
+	 * Print end of run summary, counted from when the task started
+	 * @param counter - used for output
+	 */
+	void report(Counter *counter);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Publish rates and residency since the last sample
+	 * @param elapsedUs
+	 */
+	void sample(uint64_t elapsedUs);
+
+	/***
+	 * Send new events from the migration logs to the TST monitor
+	 */
+	void logEvents();
+
+	/***
+	 * Name of the Agent with a task number
+	 * @param taskNumber
+	 * @return
+	 */
+	static const char * taskName(uint8_t taskNumber);
+
+	uint32_t xLastMigrations[TRACE_MAX_TASKS];
+	uint32_t xLastResidentUs[TRACE_MAX_TASKS][MAX_CORES];
+	uint32_t xStartMigrations[TRACE_MAX_TASKS];		//When run started, for report
+	uint32_t xStartResidentUs[TRACE_MAX_TASKS][MAX_CORES];
+	uint32_t xLogTail[MAX_CORES];
+	uint32_t xLogged = 0;
+	uint32_t xDropped = 0;
+	uint64_t xStartUs = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_MIGRATIONMONITOR_H_ */
@@ -0,0 +1,194 @@
+/*
+ * NoiseAgent.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "NoiseAgent.h"
+#include "hardware/dma.h"
+#include <cstring>
+
+NoiseAgent::NoiseAgent() {
+	for (uint32_t i = 0; i < NOISE_BUF_WORDS; i++){
+		xSrc[i] = i;
+	}
+	for (uint8_t i = 0; i < NOISE_HEAP_BLOCKS; i++){
+		pBlocks[i] = NULL;
+	}
+}
+
+NoiseAgent::~NoiseAgent() {
+	stop();
+}
+
+void NoiseAgent::setMode(NoiseMode mode){
+	xMode = mode;
+	if (xHandle != NULL){
+		xTaskAbortDelay(xHandle);
+	}
+}
+
+NoiseMode NoiseAgent::getMode(){
+	return xMode;
+}
+
+void NoiseAgent::setIrqRate(uint32_t hz){
+	xIrqHz = hz;
+}
+
+void NoiseAgent::setCpuBurst(uint32_t burstMs, uint32_t periodMs){
+	xBurstMs = burstMs;
+	xPeriodMs = (periodMs > burstMs) ? periodMs : burstMs + 1;
+}
+
+const char * NoiseAgent::modeName(NoiseMode mode){
+	switch(mode){
+	case NOISE_NONE:	return "none";
+	case NOISE_DMA:		return "dma";
+	case NOISE_MEMCPY:	return "memcpy";
+	case NOISE_IRQ:		return "irq";
+	case NOISE_HEAP:	return "heap";
+	case NOISE_CPU:		return "cpu+1";
+	case NOISE_CPU_HIGH:	return "cpu+3";
+	default:			return "?";
+	}
+}
+
+/***
+ * Task main run loop
+ */
+void NoiseAgent::run(){
+	while (!isStopRequested()){
+		heartbeat();
+		NoiseMode mode = xMode;
+		if (mode != xActive){
+			leave(xActive);
+			enter(mode);
+			xActive = mode;
+		}
+		step();
+	}
+	leave(xActive);
+	xActive = NOISE_NONE;
+}
+
+void NoiseAgent::enter(NoiseMode mode){
+	switch(mode){
+	case NOISE_DMA: {
+		//Read a 1KB ring and write one word, so only the bus is loaded
+		xDma = dma_claim_unused_channel(false);
+		if (xDma < 0){
+			break;
+		}
+		dma_channel_config c = dma_channel_get_default_config(xDma);
+		channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+		channel_config_set_read_increment(&c, true);
+		channel_config_set_write_increment(&c, false);
+		channel_config_set_ring(&c, false, 10);
+		dma_channel_configure(xDma, &c, xDst, xSrc, 0x0FFFFFFF, true);
+		break;
+	}
+	case NOISE_IRQ:
+		xIrqCount = 0;
+		add_repeating_timer_us(-(int64_t)(1000000 / xIrqHz), NoiseAgent::irqCB,
+				this, &xTimer);
+		break;
+	case NOISE_CPU:
+		vTaskPrioritySet(xHandle, getPriority() + NOISE_CPU_STEP);
+		break;
+	case NOISE_CPU_HIGH:
+		vTaskPrioritySet(xHandle, getPriority() + NOISE_CPU_HIGH_STEP);
+		break;
+	default:
+		break;
+	}
+}
+
+void NoiseAgent::leave(NoiseMode mode){
+	switch(mode){
+	case NOISE_DMA:
+		if (xDma >= 0){
+			dma_channel_abort(xDma);
+			dma_channel_unclaim(xDma);
+			xDma = -1;
+		}
+		break;
+	case NOISE_IRQ:
+		cancel_repeating_timer(&xTimer);
+		break;
+	case NOISE_HEAP:
+		for (uint8_t i = 0; i < NOISE_HEAP_BLOCKS; i++){
+			if (pBlocks[i] != NULL){
+				vPortFree(pBlocks[i]);
+				pBlocks[i] = NULL;
+			}
+		}
+		break;
+	case NOISE_CPU:
+	case NOISE_CPU_HIGH:
+		vTaskPrioritySet(xHandle, getPriority());
+		break;
+	default:
+		break;
+	}
+}
+
+void NoiseAgent::step(){
+	switch(xActive){
+	case NOISE_DMA:
+		//Restart if the long transfer ran out
+		if ((xDma >= 0) && !dma_channel_is_busy(xDma)){
+			dma_channel_set_read_addr(xDma, xSrc, false);
+			dma_channel_set_trans_count(xDma, 0x0FFFFFFF, true);
+		}
+		delayOrStop(pdMS_TO_TICKS(NOISE_POLL_MS));
+		break;
+	case NOISE_MEMCPY: {
+		//Time sliced with the Workers, so also takes a CPU share
+		uint64_t end = time_us_64() + 1000;
+		while (time_us_64() < end){
+			memcpy(xDst, xSrc, sizeof(xSrc));
+			memcpy(xSrc, xDst, sizeof(xDst));
+		}
+		break;
+	}
+	case NOISE_HEAP:
+		//Mixed sizes freed out of order to fragment heap_4
+		for (uint8_t i = 0; i < NOISE_HEAP_BLOCKS; i++){
+			pBlocks[i] = pvPortMalloc(32 << (i % 6));
+		}
+		for (uint8_t i = 0; i < NOISE_HEAP_BLOCKS; i += 2){
+			vPortFree(pBlocks[i]);
+			pBlocks[i] = NULL;
+		}
+		for (uint8_t i = 1; i < NOISE_HEAP_BLOCKS; i += 2){
+			vPortFree(pBlocks[i]);
+			pBlocks[i] = NULL;
+		}
+		vTaskDelay(1);
+		break;
+	case NOISE_CPU:
+	case NOISE_CPU_HIGH:
+		busy_wait_us(xBurstMs * 1000);
+		delayOrStop(pdMS_TO_TICKS(xPeriodMs - xBurstMs));
+		break;
+	default:
+		delayOrStop(pdMS_TO_TICKS(NOISE_POLL_MS));
+		break;
+	}
+}
+
+bool NoiseAgent::irqCB(repeating_timer_t *rt){
+	NoiseAgent *agent = (NoiseAgent *)rt->user_data;
+	agent->xIrqCount = agent->xIrqCount + 1;
+	return true;
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE NoiseAgent::getMaxStackSize(){
+	return STACK_BUDGET(NoiseAgent);
+}
@@ -0,0 +1,115 @@
+/*
+ * NoiseAgent.h
+ *
+ * Noisy neighbour. Generates one kind of interference next to the
+ * PI Workers so their loss of throughput can be measured.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_NOISEAGENT_H_
+#define EXP_2CORERTOS_SRC_NOISEAGENT_H_
+
+#include "Agent.h"
+#include "pico/stdlib.h"
+
+#define NOISE_BUF_WORDS		256		//1KB, DMA read ring needs 1KB alignment
+#define NOISE_HEAP_BLOCKS	8
+#define NOISE_POLL_MS		100
+//Priority of the CPU bursts above the agent's own. The Workers run at
+//the agent's priority and TST three above it.
+#define NOISE_CPU_STEP		1		//Preempts the Workers only
+#define NOISE_CPU_HIGH_STEP	3		//Level with TST as well
+
+enum NoiseMode {
+	NOISE_NONE = 0,
+	NOISE_DMA,			//DMA hammering SRAM
+	NOISE_MEMCPY,		//Tight memcpy between SRAM buffers
+	NOISE_IRQ,			//Timer interrupt storm
+	NOISE_HEAP,			//pvPortMalloc/vPortFree churn
+	NOISE_CPU,			//Busy bursts above the Workers
+	NOISE_CPU_HIGH,		//Busy bursts level with TST
+	NOISE_MODES
+};
+
+class NoiseAgent : public Agent {
+public:
+	NoiseAgent();
+	virtual ~NoiseAgent();
+
+	/***
+	 * Change the kind of interference, takes effect within NOISE_POLL_MS
+	 * @param mode
+	 */
+	void setMode(NoiseMode mode);
+
+	/***
+	 * Current mode
+	 * @return
+	 */
+	NoiseMode getMode();
+
+	/***
+	 * Interrupt rate for NOISE_IRQ
+	 * @param hz
+	 */
+	void setIrqRate(uint32_t hz);
+
+	/***
+	 * Burst length and period for NOISE_CPU and NOISE_CPU_HIGH
+	 * @param burstMs - time spent spinning
+	 * @param periodMs - time between burst starts
+	 */
+	void setCpuBurst(uint32_t burstMs, uint32_t periodMs);
+
+	/***
+	 * Short name of a mode for reports
+	 * @param mode
+	 * @return
+	 */
+	static const char * modeName(NoiseMode mode);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Start and stop the background parts of a mode
+	 */
+	void enter(NoiseMode mode);
+	void leave(NoiseMode mode);
+
+	/***
+	 * One slice of work in the current mode
+	 */
+	void step();
+
+	static bool irqCB(repeating_timer_t *rt);
+
+	volatile NoiseMode xMode = NOISE_NONE;
+	NoiseMode xActive = NOISE_NONE;
+
+	uint32_t xIrqHz = 20000;
+	uint32_t xBurstMs = 5;
+	uint32_t xPeriodMs = 20;
+
+	int xDma = -1;
+	repeating_timer_t xTimer;
+	volatile uint32_t xIrqCount = 0;
+	void *pBlocks[NOISE_HEAP_BLOCKS];
+
+	alignas(NOISE_BUF_WORDS * 4) uint32_t xSrc[NOISE_BUF_WORDS];
+	uint32_t xDst[NOISE_BUF_WORDS];
+};
+
+#endif /* EXP_2CORERTOS_SRC_NOISEAGENT_H_ */
@@ -0,0 +1,60 @@
+/*
+ * NoiseBench.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "NoiseBench.h"
+#include "TextBuffer.h"
+
+NoiseBench::NoiseBench(NoiseAgent *noise, TSTAgent *tst, Counter *counter) {
+	pNoise = noise;
+	pTst = tst;
+	pCounter = counter;
+	for (int i = 0; i < NOISE_MODES; i++){
+		xRate[i] = 0;
+		xTstP99Us[i] = 0;
+		xTstMaxUs[i] = 0;
+	}
+}
+
+NoiseBench::~NoiseBench() {
+	// NOP
+}
+
+void NoiseBench::run(uint32_t phaseMs){
+	for (int m = NOISE_NONE; m < NOISE_MODES; m++){
+		pNoise->setMode((NoiseMode)m);
+		vTaskDelay(pdMS_TO_TICKS(NOISE_SETTLE_MS));
+
+		pTst->resetLatency();
+		pCounter->start();
+		vTaskDelay(pdMS_TO_TICKS(phaseMs));
+		pCounter->stop();
+
+		uint32_t ms = pCounter->getSampleMs();
+		xRate[m] = (uint32_t)(((uint64_t)pCounter->getTotal() * 100000) / ms);
+		xTstP99Us[m] = pTst->getLatency()->percentile(990);
+		xTstMaxUs[m] = pTst->getLatency()->getMax();
+	}
+	pNoise->setMode(NOISE_NONE);
+}
+
+void NoiseBench::report(){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+	uint32_t base = xRate[NOISE_NONE];
+
+	pCounter->print("Noise\t+Per sec\t+% base\t+TST p99 us\t+max us\n\r");
+	for (int m = NOISE_NONE; m < NOISE_MODES; m++){
+		uint32_t pct = (base > 0) ? (xRate[m] * 1000) / base : 0;
+		text.clear();
+		text.add(NoiseAgent::modeName((NoiseMode)m))
+			.add('\t').addFixed(xRate[m], 2)
+			.add("\t\t").addFixed(pct, 1)
+			.add('\t').addUnsigned(xTstP99Us[m])
+			.add("\t\t").addUnsigned(xTstMaxUs[m]).add("\n\r");
+		pCounter->print(text.c_str());
+	}
+}
@@ -0,0 +1,48 @@
+/*
+ * NoiseBench.h
+ *
+ * Steps a NoiseAgent through each kind of interference and measures
+ * Worker throughput and TST response latency against the quiet baseline.
+ * Latency is only seen while the host is polling TST.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_NOISEBENCH_H_
+#define EXP_2CORERTOS_SRC_NOISEBENCH_H_
+
+#include "NoiseAgent.h"
+#include "TSTAgent.h"
+#include "Counter.h"
+
+#define NOISE_PHASE_MS	10000
+#define NOISE_SETTLE_MS	500
+
+class NoiseBench {
+public:
+	NoiseBench(NoiseAgent *noise, TSTAgent *tst, Counter *counter);
+	virtual ~NoiseBench();
+
+	/***
+	 * Run every mode in turn, blocks the calling task
+	 * @param phaseMs - measurement time per mode
+	 */
+	void run(uint32_t phaseMs = NOISE_PHASE_MS);
+
+	/***
+	 * Print table of results relative to NOISE_NONE
+	 */
+	void report();
+
+private:
+	NoiseAgent *pNoise;
+	TSTAgent *pTst;
+	Counter *pCounter;
+
+	uint32_t xRate[NOISE_MODES];	//Iterations per sec x100
+	uint32_t xTstP99Us[NOISE_MODES];
+	uint32_t xTstMaxUs[NOISE_MODES];
+};
+
+#endif /* EXP_2CORERTOS_SRC_NOISEBENCH_H_ */
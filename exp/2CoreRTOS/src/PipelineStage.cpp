@@ -0,0 +1,91 @@
+/*
+ * PipelineStage.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "PipelineStage.h"
+
+void PipelineLink::connect(PipelineStage *producer, PipelineStage *consumer){
+	pProducer = producer;
+	pConsumer = consumer;
+}
+
+void PipelineLink::push(const ResultBlock &block){
+	if (!xQueue.push(block)){
+		xStalls++;
+		while (!xQueue.push(block)){
+			pProducer->waitWake(1);
+		}
+	}
+	pConsumer->wake();
+}
+
+bool PipelineLink::pop(ResultBlock &block){
+	if (xQueue.pop(block)){
+		pProducer->wake();
+		return true;
+	}
+	return false;
+}
+
+uint32_t PipelineLink::size() const {
+	return xQueue.size();
+}
+
+uint32_t PipelineLink::highWater() const {
+	return xQueue.highWater();
+}
+
+uint32_t PipelineLink::capacity() const {
+	return xQueue.capacity();
+}
+
+uint32_t PipelineLink::getStalls() const {
+	return xStalls;
+}
+
+
+PipelineStage::PipelineStage() {
+	// NOP
+}
+
+PipelineStage::~PipelineStage() {
+	stop();
+}
+
+void PipelineStage::setCore(int8_t core){
+	xCore = core;
+}
+
+uint32_t PipelineStage::getItems() const {
+	return xItems;
+}
+
+uint32_t PipelineStage::getBusyUs() const {
+	return xBusyUs;
+}
+
+void PipelineStage::wake(){
+	if (xHandle != NULL){
+		xTaskNotifyGive(xHandle);
+	}
+}
+
+void PipelineStage::waitWake(uint32_t ms){
+	ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+}
+
+void PipelineStage::place(){
+	if (xCore != PIPELINE_ANY_CORE){
+		UBaseType_t uxCoreAffinityMask;
+		uxCoreAffinityMask = ( ( 1 << xCore ) );
+		vTaskCoreAffinitySet( xHandle, uxCoreAffinityMask );
+	}
+}
+
+void PipelineStage::account(uint64_t startUs){
+	xBusyUs = xBusyUs + (uint32_t)(time_us_64() - startUs);
+	xItems = xItems + 1;
+}
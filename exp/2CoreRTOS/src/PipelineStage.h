@@ -0,0 +1,137 @@
+/*
+ * PipelineStage.h
+ *
+ * Base for an agent that forms one stage of the compute pipeline.
+ * Stages are joined by bounded lock free links. A producer that finds
+ * its output link full waits for the consumer, giving backpressure.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_PIPELINESTAGE_H_
+#define EXP_2CORERTOS_SRC_PIPELINESTAGE_H_
+
+#include "Agent.h"
+#include "SpscQueue.h"
+#include "Mailbox.h"
+#include "pico/stdlib.h"
+
+#define PIPELINE_QUEUE_LEN	8
+#define PIPELINE_ANY_CORE	-1
+
+/***
+ * Result of one compute job
+ */
+struct ResultBlock {
+	uint32_t xSeq;
+	uint32_t xChecksum;
+	uint32_t xPrefix;		//First 8 digits packed as decimal
+	uint32_t xComputeUs;
+	uint8_t  xWorker;
+	uint8_t  xCore;
+	bool 	 xValid;
+};
+
+typedef Mailbox<ResultBlock, PIPELINE_QUEUE_LEN> ResultMailbox;
+
+class PipelineStage;
+
+/***
+ * Link between two stages
+ */
+class PipelineLink {
+public:
+	/***
+	 * Connect the two ends of the link
+	 * @param producer
+	 * @param consumer
+	 */
+	void connect(PipelineStage *producer, PipelineStage *consumer);
+
+	/***
+	 * Push, waiting while the link is full
+	 * @param block
+	 */
+	void push(const ResultBlock &block);
+
+	/***
+	 * Pop without waiting
+	 * @param block
+	 * @return false if empty
+	 */
+	bool pop(ResultBlock &block);
+
+	uint32_t size() const;
+	uint32_t highWater() const;
+	uint32_t capacity() const;
+
+	/***
+	 * Number of times the producer found the link full
+	 * @return
+	 */
+	uint32_t getStalls() const;
+
+private:
+	SpscQueue<ResultBlock, PIPELINE_QUEUE_LEN> xQueue;
+	PipelineStage *pProducer = NULL;
+	PipelineStage *pConsumer = NULL;
+	uint32_t xStalls = 0;
+};
+
+
+class PipelineStage : public Agent {
+public:
+	PipelineStage();
+	virtual ~PipelineStage();
+
+	/***
+	 * Place the stage on a core
+	 * @param core - 0, 1 or PIPELINE_ANY_CORE
+	 */
+	void setCore(int8_t core);
+
+	/***
+	 * Blocks handled since start
+	 * @return
+	 */
+	uint32_t getItems() const;
+
+	/***
+	 * Microseconds spent doing work since start. Wraps after 71 minutes,
+	 * take differences as uint32_t
+	 * @return
+	 */
+	uint32_t getBusyUs() const;
+
+	/***
+	 * Wake the stage, used by links when data or space arrives
+	 */
+	void wake();
+
+	/***
+	 * Sleep until woken or timeout
+	 * @param ms
+	 */
+	void waitWake(uint32_t ms);
+
+protected:
+	/***
+	 * Apply core placement, call at top of run
+	 */
+	void place();
+
+	/***
+	 * Record one item handled
+	 * @param startUs - time_us_64 when work on the item began
+	 */
+	void account(uint64_t startUs);
+
+private:
+	int8_t xCore = PIPELINE_ANY_CORE;
+	volatile uint32_t xItems = 0;
+	//32 bit so a reader on the other core never sees a torn value
+	volatile uint32_t xBusyUs = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_PIPELINESTAGE_H_ */
@@ -0,0 +1,251 @@
+/*
+ * Profiler.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "Profiler.h"
+#include "Agent.h"
+#include "AgentRegistry.h"
+#include "TextBuffer.h"
+#include "hardware/timer.h"
+#include "hardware/irq.h"
+
+Profiler *Profiler::pSingleton = NULL;
+
+static_assert(TRACE_MAX_TASKS <= 32, "Named tasks are kept in a 32 bit mask");
+
+extern "C" void profilerSample(const uint32_t *frame, uint32_t excReturn){
+	Profiler::getInstance()->sample(frame, excReturn);
+}
+
+#if PROFILER_SUPPORTED
+/***
+ * Alarm handler. Passes the stacked frame, from the process stack when
+ * a task was interrupted or the main stack when a handler was, before
+ * anything else is pushed. profilerSample returns through the
+ * EXC_RETURN still in lr.
+ */
+extern "C" __attribute__((naked)) void profilerIrq(void){
+	__asm volatile(
+		"tst lr, #4\n"
+		"ite eq\n"
+		"mrseq r0, msp\n"
+		"mrsne r0, psp\n"
+		"mov r1, lr\n"
+		"b profilerSample\n"
+	);
+}
+#endif
+
+Profiler::Profiler() {
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xAlarm[c] = -1;
+		xNext[c] = 0;
+		xTaken[c] = 0;
+		xDropped[c] = 0;
+		xEnabled[c] = false;
+	}
+}
+
+Profiler::~Profiler() {
+	stop();
+}
+
+Profiler * Profiler::getInstance(){
+	if (Profiler::pSingleton == NULL){
+		Profiler::pSingleton = new Profiler;
+	}
+	return Profiler::pSingleton;
+}
+
+bool Profiler::start(uint32_t hz){
+#if PROFILER_SUPPORTED
+	if (xRunning || (hz == 0)){
+		return false;
+	}
+	xPeriodUs = 1000000 / hz;
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xAlarm[c] = hardware_alarm_claim_unused(false);
+		if (xAlarm[c] < 0){
+			stop();
+			return false;
+		}
+		irq_set_exclusive_handler(hardware_alarm_get_irq_num(xAlarm[c]), profilerIrq);
+		hw_set_bits(&timer_hw->inte, 1u << xAlarm[c]);
+	}
+	xRunning = true;
+
+	//Interrupts are enabled per core, so from a task on each core
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xTaskCreateAffinitySet(Profiler::enableCore, "Profiler", 256, this,
+				configMAX_PRIORITIES - 1, 1 << c, NULL);
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Profiler::enableCore(void *params){
+	Profiler *self = (Profiler *)params;
+	uint8_t core = get_core_num();
+	uint8_t alarm = (uint8_t)self->xAlarm[core];
+
+	self->xNext[core] = time_us_32() + self->xPeriodUs + core * (self->xPeriodUs / 2);
+	timer_hw->alarm[alarm] = self->xNext[core];
+	irq_set_enabled(hardware_alarm_get_irq_num(alarm), true);
+	self->xEnabled[core] = true;
+	vTaskDelete(NULL);
+}
+
+void Profiler::disableCore(void *params){
+	Profiler *self = (Profiler *)params;
+	uint8_t core = get_core_num();
+
+	irq_set_enabled(hardware_alarm_get_irq_num(self->xAlarm[core]), false);
+	self->xEnabled[core] = false;
+	xTaskNotifyGive(self->xStopper);
+	vTaskDelete(NULL);
+}
+
+void Profiler::stop(){
+#if PROFILER_SUPPORTED
+	xRunning = false;
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		if (xAlarm[c] >= 0){
+			//No alarm raises the interrupt from here
+			hw_clear_bits(&timer_hw->inte, 1u << xAlarm[c]);
+		}
+	}
+
+	//Interrupts are disabled per core too, the other core from a task
+	uint8_t core = get_core_num();
+	xStopper = xTaskGetCurrentTaskHandle();
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		if (!xEnabled[c]){
+			continue;
+		}
+		if (c == core){
+			irq_set_enabled(hardware_alarm_get_irq_num(xAlarm[c]), false);
+			xEnabled[c] = false;
+		} else if (xTaskCreateAffinitySet(Profiler::disableCore, "Profiler", 256, this,
+				configMAX_PRIORITIES - 1, 1 << c, NULL) == pdPASS){
+			ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PROFILER_STOP_MS));
+		}
+	}
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		if (xAlarm[c] < 0){
+			continue;
+		}
+		if (xEnabled[c]){
+			//Still live on a core that never ran disableCore, keep it
+			continue;
+		}
+		uint irq = hardware_alarm_get_irq_num(xAlarm[c]);
+		timer_hw->intr = 1u << xAlarm[c];
+		irq_remove_handler(irq, profilerIrq);
+		hardware_alarm_unclaim(xAlarm[c]);
+		xAlarm[c] = -1;
+	}
+#endif
+}
+
+void Profiler::sample(const uint32_t *frame, uint32_t excReturn){
+	uint8_t core = get_core_num();
+	int alarm = xAlarm[core];
+	if (alarm < 0){
+		return;
+	}
+	timer_hw->intr = 1u << alarm;
+
+	//Rearm from the last target so the rate does not drift, skipping
+	//any periods missed while interrupts were masked
+	uint32_t now = time_us_32();
+	uint32_t next = xNext[core] + xPeriodUs;
+	if ((int32_t)(next - now) <= 0){
+		next = now + xPeriodUs;
+	}
+	xNext[core] = next;
+	timer_hw->alarm[alarm] = next;
+
+	Sample s;
+	s.xPc = frame[6];
+	s.xTask = (uint8_t)uxTaskGetTaskNumber(xTaskGetCurrentTaskHandleForCore(core));
+	s.xFlags = (excReturn & 0x08) ? 0 : PROFILER_FLAG_HANDLER;
+	xTaken[core]++;
+	if (!xSamples[core].push(s)){
+		xDropped[core]++;
+	}
+}
+
+void Profiler::flush(CpuMonitor *cpu){
+	char line[16 + 12 * PROFILER_LINE_SAMPLES];
+	TextBuffer text(line, sizeof(line));
+	Counter *counter = Counter::getInstance();
+	Sample s;
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		uint8_t n = 0;
+		while (xSamples[c].pop(s)){
+			nameTask(s.xTask, cpu);
+			if (n == 0){
+				text.clear();
+				text.add("PROF ").addUnsigned(c).add(' ');
+			}
+			//Each sample as 12 hex digits: pc, task, flags
+			text.addHex(s.xPc, 8).addHex(s.xTask, 2).addHex(s.xFlags, 2);
+			if (++n == PROFILER_LINE_SAMPLES){
+				text.add("\n\r");
+				counter->print(text.c_str());
+				n = 0;
+			}
+		}
+		if (n != 0){
+			text.add("\n\r");
+			counter->print(text.c_str());
+		}
+	}
+}
+
+void Profiler::nameTask(uint8_t task, CpuMonitor *cpu){
+	if ((task == 0) || (task >= TRACE_MAX_TASKS) || (xNamed & (1u << task))){
+		return;
+	}
+	const char *name = NULL;
+	if (cpu != NULL){
+		name = cpu->taskName(task);
+	} else {
+		Agent *agent = AgentRegistry::getAgent(task - 1);
+		if (agent != NULL){
+			name = agent->getName();
+		}
+	}
+	if (name == NULL){
+		return;
+	}
+	xNamed |= 1u << task;
+
+	char line[48];
+	TextBuffer text(line, sizeof(line));
+	text.add("PROF task=").addUnsigned(task).add(" name=").add(name).add("\n\r");
+	Counter::getInstance()->print(text.c_str());
+}
+
+void Profiler::report(Counter *counter){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	text.add("Profiler ").addUnsigned(xPeriodUs ? 1000000 / xPeriodUs : 0).add(" Hz\n\r");
+	counter->print(text.c_str());
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		text.clear();
+		text.add("Core ").addUnsigned(c)
+			.add(" samples ").addUnsigned(xTaken[c])
+			.add(" dropped ").addUnsigned(xDropped[c]).add("\n\r");
+		counter->print(text.c_str());
+	}
+}
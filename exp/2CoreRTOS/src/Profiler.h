@@ -0,0 +1,128 @@
+/*
+ * Profiler.h
+ *
+ * Statistical profiler. A timer alarm per core interrupts at a fixed
+ * rate and takes the PC and task number the interrupt stacked. Samples
+ * wait in a ring per core until flush sends them as PROF lines for
+ * tools/profile.py to symbolise against the elf.
+ *
+ * The rate is kept prime so sampling does not lock step with the tick
+ * or with 100 ms periodic tasks. Core 1 is offset by half a period.
+ *
+ * Not an Agent, flush is called by TSTMetrics every 100 ms.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_PROFILER_H_
+#define EXP_2CORERTOS_SRC_PROFILER_H_
+
+#include "Counter.h"
+#include "CpuMonitor.h"
+#include "SpscQueue.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if PICO_RP2350 && !defined(__riscv)
+#define PROFILER_SUPPORTED	1
+#else
+#define PROFILER_SUPPORTED	0
+#endif
+
+#ifndef PROFILER_HZ
+#define PROFILER_HZ				97		//Samples per second per core
+#endif
+#define PROFILER_SAMPLES		128		//Ring per core, power of two
+#define PROFILER_LINE_SAMPLES	8		//Samples per PROF line
+#define PROFILER_STOP_MS		100		//Wait for the other core to disable
+
+#define PROFILER_FLAG_HANDLER	0x01	//Interrupted an interrupt handler
+
+class Profiler {
+public:
+	/***
+	 * One sample, task is 0 for tasks without a number
+	 */
+	struct Sample {
+		uint32_t xPc;
+		uint8_t  xTask;
+		uint8_t  xFlags;
+	};
+
+	static Profiler * getInstance();
+
+	/***
+	 * Claim an alarm for each core and start sampling
+	 * @param hz - samples per second on each core
+	 * @return false if alarms are not available or not supported
+	 */
+	bool start(uint32_t hz = PROFILER_HZ);
+
+	/***
+	 * Stop sampling, disable the alarm interrupt on each core, remove
+	 * the handlers and release the alarms. Call from a task.
+	 */
+	void stop();
+
+	/***
+	 * Send waiting samples as PROF lines, naming each task number the
+	 * first time it is seen
+	 * @param cpu - names tasks that are not Agents, may be NULL
+	 */
+	void flush(CpuMonitor *cpu);
+
+	/***
+	 * Print samples taken and lost on each core
+	 * @param counter - used for output
+	 */
+	void report(Counter *counter);
+
+	/***
+	 * Take a sample, called from the alarm interrupt
+	 * @param frame - exception frame stacked on entry
+	 * @param excReturn - EXC_RETURN value from entry
+	 */
+	void sample(const uint32_t *frame, uint32_t excReturn);
+
+private:
+	Profiler();
+	virtual ~Profiler();
+
+	/***
+	 * Enable the alarm interrupt on the core it runs on, then exit.
+	 * Run as a task pinned to each core.
+	 * @param params - Profiler
+	 */
+	static void enableCore(void *params);
+
+	/***
+	 * Disable the alarm interrupt on the core it runs on, tell stop and
+	 * exit. Run as a task pinned to the core stop is not on.
+	 * @param params - Profiler
+	 */
+	static void disableCore(void *params);
+
+	/***
+	 * Send "PROF task=N name=X" for a task number not yet named
+	 * @param task
+	 * @param cpu
+	 */
+	void nameTask(uint8_t task, CpuMonitor *cpu);
+
+	static Profiler *pSingleton;
+
+	SpscQueue<Sample, PROFILER_SAMPLES> xSamples[MAX_CORES];
+	int xAlarm[MAX_CORES];
+	uint32_t xNext[MAX_CORES];
+	uint32_t xTaken[MAX_CORES];
+	uint32_t xDropped[MAX_CORES];
+	volatile bool xEnabled[MAX_CORES];
+	TaskHandle_t xStopper = NULL;
+	uint32_t xPeriodUs = 0;
+	uint32_t xNamed = 0;
+	bool xRunning = false;
+};
+
+#endif /* EXP_2CORERTOS_SRC_PROFILER_H_ */
@@ -0,0 +1,126 @@
+/*
+ * PublishStage.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "PublishStage.h"
+#include "TextBuffer.h"
+
+PublishStage::PublishStage() : xMail(this) {
+	// NOP
+}
+
+PublishStage::~PublishStage() {
+	stop();
+}
+
+ResultMailbox *PublishStage::getMailbox(){
+	return &xMail;
+}
+
+bool PublishStage::addStage(PipelineStage *stage){
+	if (xStages >= PUBLISH_MAX_STAGES){
+		return false;
+	}
+	xLastItems[xStages] = 0;
+	xLastBusy[xStages] = 0;
+	pStages[xStages++] = stage;
+	return true;
+}
+
+bool PublishStage::addLink(PipelineLink *link){
+	if (xLinks >= PUBLISH_MAX_LINKS){
+		return false;
+	}
+	pLinks[xLinks++] = link;
+	return true;
+}
+
+void PublishStage::setVerifier(VerifyStage *verify){
+	pVerify = verify;
+}
+
+/***
+ * Task main run loop
+ */
+void PublishStage::run(){
+	place();
+
+	uint64_t last = time_us_64();
+	for (;;){
+		heartbeat();
+		MessagePtr<ResultBlock> msg = xMail.receive(pdMS_TO_TICKS(10));
+		while (msg){
+			uint64_t start = time_us_64();
+			if (msg->xValid){
+				xValid++;
+			} else {
+				xInvalid++;
+			}
+			account(start);
+
+			//Back to the verifier's pool, which may be waiting for it
+			msg.reset();
+			if (pVerify != NULL){
+				pVerify->wake();
+			}
+			msg = xMail.tryReceive();
+		}
+
+		uint64_t now = time_us_64();
+		if ((now - last) >= (PUBLISH_PERIOD_MS * 1000)){
+			publish(now - last);
+			last = now;
+		}
+	}
+}
+
+void PublishStage::publish(uint64_t periodUs){
+	char msg[128];
+	TextBuffer text(msg, sizeof(msg));
+
+	for (uint8_t i = 0; i < xStages; i++){
+		uint32_t items = pStages[i]->getItems();
+		uint32_t busy = pStages[i]->getBusyUs();
+		TST_V.pipeRate[i] = (uint16_t)(
+				((uint64_t)(items - xLastItems[i]) * 100000000ULL) / periodUs);
+		TST_V.pipeBusy[i] = (uint16_t)(((uint64_t)(busy - xLastBusy[i]) * 1000) / periodUs);
+		xLastItems[i] = items;
+		xLastBusy[i] = busy;
+	}
+	for (uint8_t i = 0; i < xLinks; i++){
+		TST_V.pipeDepth[i] = pLinks[i]->size();
+		TST_V.pipeDepthHigh[i] = pLinks[i]->highWater();
+	}
+	TST_V.pipeDepth[xLinks] = xMail.size();
+	TST_V.pipeDepthHigh[xLinks] = xMail.highWater();
+	if (pVerify != NULL){
+		TST_V.pipeErrors = pVerify->getErrors();
+	}
+
+	text.add("Pipe ok ").addUnsigned(xValid)
+		.add(" bad ").addUnsigned(xInvalid).add(" rate");
+	for (uint8_t i = 0; i < xStages; i++){
+		text.add(' ').addFixed(TST_V.pipeRate[i], 2);
+	}
+	for (uint8_t i = 0; i < xLinks; i++){
+		text.add(" q").addUnsigned(i)
+			.add('=').addUnsigned(pLinks[i]->size())
+			.add('/').addUnsigned(pLinks[i]->getStalls());
+	}
+	text.add(" mail=").addUnsigned(xMail.size());
+	if (pVerify != NULL){
+		text.add('/').addUnsigned(pVerify->getStalls());
+	}
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE PublishStage::getMaxStackSize(){
+	return STACK_BUDGET(PublishStage);
+}
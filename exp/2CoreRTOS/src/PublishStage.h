@@ -0,0 +1,92 @@
+/*
+ * PublishStage.h
+ *
+ * Final pipeline stage. Receives verified blocks in its mailbox and
+ * streams a summary, with per stage throughput and link and mailbox
+ * occupancy, over TST.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_PUBLISHSTAGE_H_
+#define EXP_2CORERTOS_SRC_PUBLISHSTAGE_H_
+
+#include "PipelineStage.h"
+#include "VerifyStage.h"
+extern "C"{
+#include "tst_variables.h"
+}
+
+#define PUBLISH_MAX_STAGES	6
+#define PUBLISH_MAX_LINKS	5		//TST_V.pipeDepth keeps one entry for the mailbox
+#define PUBLISH_PERIOD_MS	1000
+
+class PublishStage : public PipelineStage {
+public:
+	PublishStage();
+	virtual ~PublishStage();
+
+	/***
+	 * Mailbox the verifier posts to
+	 * @return
+	 */
+	ResultMailbox *getMailbox();
+
+	/***
+	 * Add a stage to be instrumented. Include this stage to see its
+	 * own throughput.
+	 * @param stage
+	 * @return false if no room
+	 */
+	bool addStage(PipelineStage *stage);
+
+	/***
+	 * Add a link to be instrumented, the mailbox is reported after them
+	 * @param link
+	 * @return false if no room
+	 */
+	bool addLink(PipelineLink *link);
+
+	/***
+	 * Verifier to take error count from, woken when mail is taken
+	 * @param verify
+	 */
+	void setVerifier(VerifyStage *verify);
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Update TST_V and send summary to monitor
+	 * @param periodUs - time since last publish
+	 */
+	void publish(uint64_t periodUs);
+
+	ResultMailbox xMail;
+
+	PipelineStage *pStages[PUBLISH_MAX_STAGES];
+	uint32_t xLastItems[PUBLISH_MAX_STAGES];
+	uint32_t xLastBusy[PUBLISH_MAX_STAGES];
+	uint8_t xStages = 0;
+
+	PipelineLink *pLinks[PUBLISH_MAX_LINKS];
+	uint8_t xLinks = 0;
+
+	VerifyStage *pVerify = NULL;
+
+	uint32_t xValid = 0;
+	uint32_t xInvalid = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_PUBLISHSTAGE_H_ */
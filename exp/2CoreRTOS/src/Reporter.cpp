@@ -0,0 +1,141 @@
+/*
+ * Reporter.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "Reporter.h"
+#include "Counter.h"
+#include "hardware/dma.h"
+#include <cstring>
+
+Reporter::Reporter(uart_inst_t *uart) {
+	pUart = uart;
+	xStream = xStreamBufferCreateStatic(REPORTER_STREAM, 1,
+			xStreamStorage, &xStreamBuffer);
+	xMutex = xSemaphoreCreateMutexStatic(&xMutexBuffer);
+}
+
+Reporter::~Reporter() {
+	stop();
+	if (xDma >= 0){
+		dma_channel_unclaim(xDma);
+	}
+}
+
+void Reporter::write(const char *s){
+	size_t len = strlen(s);
+
+	if ((xHandle == NULL) || (xDma < 0)){
+		uart_puts(pUart, s);
+		return;
+	}
+
+	//The reporter formats its own report, it must not wait on itself
+	bool self = (xTaskGetCurrentTaskHandle() == xHandle);
+	TickType_t start = xTaskGetTickCount();
+
+	//The mutex only covers the send, never a wait for space, so a
+	//waiting writer cannot hold up the reporter. Lines go in whole.
+	while (len > 0){
+		size_t part = (len < REPORTER_STREAM) ? len : REPORTER_STREAM;
+		size_t sent = 0;
+		xSemaphoreTake(xMutex, portMAX_DELAY);
+		if (xStreamBufferSpacesAvailable(xStream) >= part){
+			sent = xStreamBufferSend(xStream, s, part, 0);
+		}
+		xSemaphoreGive(xMutex);
+		s += sent;
+		len -= sent;
+		if ((len == 0) || (sent > 0)){
+			continue;
+		}
+
+		if (self){
+			drain();
+		} else if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(REPORTER_WAIT_MS)){
+			xSemaphoreTake(xMutex, portMAX_DELAY);
+			xDropped += len;
+			xSemaphoreGive(xMutex);
+			break;
+		} else {
+			xTaskNotifyGive(xHandle);
+			vTaskDelay(1);
+		}
+	}
+	xTaskNotifyGive(xHandle);
+}
+
+void Reporter::request(){
+	xPending = true;
+	if (xHandle != NULL){
+		xTaskNotifyGive(xHandle);
+	}
+}
+
+void Reporter::requestFromISR(BaseType_t *pxHigherPriorityTaskWoken){
+	xPending = true;
+	if (xHandle != NULL){
+		vTaskNotifyGiveFromISR(xHandle, pxHigherPriorityTaskWoken);
+	}
+}
+
+uint32_t Reporter::getDropped(){
+	return xDropped;
+}
+
+/***
+ * Task main run loop
+ */
+void Reporter::run(){
+	if (xDma < 0){
+		xDma = dma_claim_unused_channel(false);
+	}
+	if (xDma >= 0){
+		dma_channel_config c = dma_channel_get_default_config(xDma);
+		channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+		channel_config_set_read_increment(&c, true);
+		channel_config_set_write_increment(&c, false);
+		channel_config_set_dreq(&c, uart_get_dreq(pUart, true));
+		dma_channel_configure(xDma, &c, &uart_get_hw(pUart)->dr, xChunk, 0, false);
+	}
+
+	for (;;){
+		heartbeat();
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		if (xPending){
+			xPending = false;
+			Counter::getInstance()->report();
+		}
+		drain();
+	}
+}
+
+void Reporter::drain(){
+	size_t len;
+	while ((len = xStreamBufferReceive(xStream, xChunk, REPORTER_CHUNK, 0)) > 0){
+		send(len);
+	}
+}
+
+void Reporter::send(size_t len){
+	if (xDma < 0){
+		uart_write_blocking(pUart, xChunk, len);
+		return;
+	}
+	dma_channel_set_read_addr(xDma, xChunk, false);
+	dma_channel_set_trans_count(xDma, len, true);
+	//A chunk takes about 5ms at 115200 baud
+	while (dma_channel_is_busy(xDma)){
+		vTaskDelay(1);
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE Reporter::getMaxStackSize(){
+	return STACK_BUDGET(Reporter);
+}
@@ -0,0 +1,94 @@
+/*
+ * Reporter.h
+ *
+ * Low priority agent that owns report output. Text is queued in a
+ * stream buffer and sent to the UART by DMA, so neither the caller
+ * nor an interrupt ever waits on the UART.
+ *
+ * The end of window alarm only asks for a report, the Counter record
+ * it formats was captured when the window closed.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_REPORTER_H_
+#define EXP_2CORERTOS_SRC_REPORTER_H_
+
+#include "Agent.h"
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "stream_buffer.h"
+#include "semphr.h"
+
+#define REPORTER_STREAM		2048	//Bytes of text waiting to be sent
+#define REPORTER_CHUNK		64		//Bytes per DMA transfer
+#define REPORTER_WAIT_MS	100		//Longest a writer waits for space, polled each tick
+
+class Reporter : public Agent {
+public:
+	Reporter(uart_inst_t *uart);
+	virtual ~Reporter();
+
+	/***
+	 * Queue text for output. Task context only. Before the agent is
+	 * started the text is written directly.
+	 * @param s
+	 */
+	void write(const char *s);
+
+	/***
+	 * Ask for the Counter report
+	 */
+	void request();
+
+	/***
+	 * Ask for the Counter report from an interrupt
+	 * @param pxHigherPriorityTaskWoken - set if a yield is needed
+	 */
+	void requestFromISR(BaseType_t *pxHigherPriorityTaskWoken);
+
+	/***
+	 * Bytes dropped because the stream stayed full
+	 * @return
+	 */
+	uint32_t getDropped();
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	/***
+	 * Send everything queued so far
+	 */
+	void drain();
+
+	/***
+	 * Send one chunk by DMA and wait for it to finish
+	 * @param len
+	 */
+	void send(size_t len);
+
+	uart_inst_t *pUart;
+	int xDma = -1;
+	volatile bool xPending = false;
+	uint32_t xDropped = 0;
+
+	StreamBufferHandle_t xStream = NULL;
+	StaticStreamBuffer_t xStreamBuffer;
+	uint8_t xStreamStorage[REPORTER_STREAM + 1];
+	SemaphoreHandle_t xMutex = NULL;
+	StaticSemaphore_t xMutexBuffer;
+	uint8_t xChunk[REPORTER_CHUNK];
+};
+
+#endif /* EXP_2CORERTOS_SRC_REPORTER_H_ */
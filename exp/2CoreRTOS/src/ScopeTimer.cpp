@@ -0,0 +1,113 @@
+/*
+ * ScopeTimer.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "ScopeTimer.h"
+#include "TextBuffer.h"
+#include "hardware/sync.h"
+
+ScopeSite *ScopeSite::pFirst = NULL;
+bool ScopeSite::xCounting[MAX_CORES] = {false, false};
+
+void ScopeSite::add(uint8_t core, uint32_t cycles){
+	if (core >= MAX_CORES){
+		return;
+	}
+	if (!xEnrolled){
+		enrol();
+	}
+
+	//Tasks on the same core share the slot, mask so updates do not tear
+	uint32_t irq = save_and_disable_interrupts();
+	if (!xCounting[core]){
+		//The start was read before the counter ran
+		xCounting[core] = CycleClock::enable();
+	} else {
+		Stats &stats = xStats[core];
+		stats.xCount++;
+		stats.xTotal += cycles;
+		if (cycles < stats.xMin){
+			stats.xMin = cycles;
+		}
+		if (cycles > stats.xMax){
+			stats.xMax = cycles;
+		}
+	}
+	restore_interrupts(irq);
+}
+
+void ScopeSite::drop(uint8_t core){
+	if (core >= MAX_CORES){
+		return;
+	}
+	if (!xEnrolled){
+		enrol();
+	}
+	uint32_t irq = save_and_disable_interrupts();
+	xStats[core].xDropped++;
+	restore_interrupts(irq);
+}
+
+void ScopeSite::enrol(){
+	if (__atomic_exchange_n(&xEnrolled, true, __ATOMIC_ACQ_REL)){
+		return;
+	}
+	ScopeSite *head = __atomic_load_n(&pFirst, __ATOMIC_ACQUIRE);
+	do {
+		pNext = head;
+	} while (!__atomic_compare_exchange_n(&pFirst, &head, this,
+			false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+ScopeSite::Stats ScopeSite::get(uint8_t core) const{
+	uint32_t irq = save_and_disable_interrupts();
+	Stats stats = xStats[core];
+	restore_interrupts(irq);
+	return stats;
+}
+
+const char *ScopeSite::getName() const{
+	return pName;
+}
+
+ScopeSite *ScopeSite::first(){
+	return __atomic_load_n(&pFirst, __ATOMIC_ACQUIRE);
+}
+
+ScopeSite *ScopeSite::next() const{
+	return pNext;
+}
+
+void ScopeSite::report(Counter *counter){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	if (first() == NULL){
+		return;
+	}
+	counter->print("Scope\t\t\tCore\tCount\tAvg\tMin\tMax\tDropped\n\r");
+	for (ScopeSite *site = first(); site != NULL; site = site->next()){
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			Stats stats = site->get(c);
+			if ((stats.xCount == 0) && (stats.xDropped == 0)){
+				continue;
+			}
+			text.clear();
+			text.add(site->getName(), 23)
+				.add('\t').addUnsigned(c)
+				.add('\t').addUnsigned(stats.xCount);
+			if (stats.xCount == 0){
+				text.add("\t-\t-\t-");
+			} else {
+				text.add('\t').addUnsigned(stats.xTotal / stats.xCount)
+					.add('\t').addUnsigned(stats.xMin)
+					.add('\t').addUnsigned(stats.xMax);
+			}
+			text.add('\t').addUnsigned(stats.xDropped).add("\n\r");
+			counter->print(text.c_str());
+		}
+	}
+}
@@ -0,0 +1,135 @@
+/*
+ * ScopeTimer.h
+ *
+ * Cycle timing of hot code paths. SCOPE_TIMER("name") at the top of a
+ * scope times it to the end of the scope and adds the cycles to the
+ * count, total, min and max of that site on the core it ran on.
+ *
+ * Each site is a function local static built at compile time, so there
+ * is no guard or allocation on first use. Sites link themselves into a
+ * list when they first record. Build with SCOPE_TIMERS=0, or configure
+ * with -DPICALC_SCOPE_TIMERS=OFF, and SCOPE_TIMER compiles to nothing.
+ *
+ * A scope that starts on one core and ends on the other is not timed,
+ * the cycle counters of the two cores are not related. It is counted as
+ * dropped against the core it started on and reported beside the
+ * timings, so a site that migrates often shows it.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_SCOPETIMER_H_
+#define EXP_2CORERTOS_SRC_SCOPETIMER_H_
+
+#include "CycleClock.h"
+#include "Counter.h"
+#include "pico/stdlib.h"
+#include <cstdint>
+
+#ifndef SCOPE_TIMERS
+#define SCOPE_TIMERS 1
+#endif
+
+class ScopeSite {
+public:
+	struct Stats {
+		uint32_t xCount;
+		uint32_t xMin;
+		uint32_t xMax;
+		uint64_t xTotal;
+		uint32_t xDropped;	//Ended on the other core
+	};
+
+	constexpr ScopeSite(const char *name) : pName(name) {
+		for (Stats &stats : xStats){
+			stats.xMin = UINT32_MAX;
+		}
+	}
+
+	/***
+	 * Add a timing for the calling core. First use on a core starts its
+	 * cycle counter and is not counted.
+	 * @param core
+	 * @param cycles
+	 */
+	void add(uint8_t core, uint32_t cycles);
+
+	/***
+	 * Count a timing lost because the scope changed core
+	 * @param core - core the scope started on
+	 */
+	void drop(uint8_t core);
+
+	/***
+	 * Copy of the stats for one core
+	 * @param core
+	 * @return
+	 */
+	Stats get(uint8_t core) const;
+
+	const char *getName() const;
+
+	/***
+	 * First site that has recorded, then next to walk the list
+	 * @return NULL at the end
+	 */
+	static ScopeSite *first();
+	ScopeSite *next() const;
+
+	/***
+	 * Print every site, per core, in cycles
+	 * @param counter - used for output
+	 */
+	static void report(Counter *counter);
+
+private:
+	/***
+	 * Link into the site list once
+	 */
+	void enrol();
+
+	const char *pName;
+	Stats xStats[MAX_CORES] = {};
+	ScopeSite *pNext = nullptr;
+	bool xEnrolled = false;
+
+	static ScopeSite *pFirst;
+	static bool xCounting[MAX_CORES];
+};
+
+/***
+ * Times from construction to destruction, use through SCOPE_TIMER
+ */
+class ScopeTimer {
+public:
+	inline ScopeTimer(ScopeSite &site) :
+		xSite(site), xCore((uint8_t)get_core_num()), xStart(CycleClock::cycles()) {}
+
+	inline ~ScopeTimer(){
+		uint32_t end = CycleClock::cycles();
+		uint8_t core = (uint8_t)get_core_num();
+		if (core == xCore){
+			xSite.add(core, end - xStart);
+		} else {
+			xSite.drop(xCore);
+		}
+	}
+
+private:
+	ScopeSite &xSite;
+	uint8_t xCore;
+	uint32_t xStart;
+};
+
+#if SCOPE_TIMERS
+#define SCOPE_TIMER_JOIN2(a, b)	a##b
+#define SCOPE_TIMER_JOIN(a, b)	SCOPE_TIMER_JOIN2(a, b)
+#define SCOPE_TIMER(name) \
+	static constinit ScopeSite SCOPE_TIMER_JOIN(scopeSite, __LINE__)(name); \
+	ScopeTimer SCOPE_TIMER_JOIN(scopeTimer, __LINE__)(SCOPE_TIMER_JOIN(scopeSite, __LINE__))
+#else
+#define SCOPE_TIMER(name)	((void)0)
+#endif
+
+#endif /* EXP_2CORERTOS_SRC_SCOPETIMER_H_ */
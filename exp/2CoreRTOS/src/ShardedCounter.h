@@ -0,0 +1,197 @@
+/*
+ * ShardedCounter.h
+ *
+ * Event counter with one shard per core. Each core only writes its
+ * own shard, with interrupts masked so tasks on that core cannot
+ * interleave, and readers sum the shards. A sequence number on each
+ * shard lets a reader take a consistent copy without blocking the
+ * writer.
+ *
+ * Each count is also a MetricSource, ids first then cores, so they can
+ * be exported through the MetricRegistry.
+ *
+ * RP2350 SRAM has no data cache, the alignment keeps each shard in
+ * its own block so the shards never share a bus word with anything
+ * else.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_SHARDEDCOUNTER_H_
+#define EXP_2CORERTOS_SRC_SHARDEDCOUNTER_H_
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "MetricRegistry.h"
+
+#define SHARD_ALIGN 32
+
+template<uint8_t IDS, uint8_t CORES>
+class ShardedCounter : public MetricSource {
+public:
+	/***
+	 * Consistent copy of all counts
+	 */
+	struct Snapshot {
+		uint32_t xIds[IDS];
+		uint32_t xCores[CORES];
+
+		/***
+		 * Remove counts that were in an earlier snapshot
+		 * @param base
+		 */
+		void since(const Snapshot &base){
+			for (uint8_t i = 0; i < IDS; i++){
+				xIds[i] -= base.xIds[i];
+			}
+			for (uint8_t c = 0; c < CORES; c++){
+				xCores[c] -= base.xCores[c];
+			}
+		}
+
+		uint32_t total() const {
+			uint32_t sum = 0;
+			for (uint8_t i = 0; i < IDS; i++){
+				sum += xIds[i];
+			}
+			return sum;
+		}
+	};
+
+	ShardedCounter(){
+		for (uint8_t s = 0; s < CORES; s++){
+			xShards[s].xSeq = 0;
+			for (uint8_t i = 0; i < IDS; i++){
+				xShards[s].xIds[i] = 0;
+			}
+			for (uint8_t c = 0; c < CORES; c++){
+				xShards[s].xCores[c] = 0;
+			}
+		}
+	}
+
+	/***
+	 * MetricSource index of an id count
+	 * @param id
+	 * @return
+	 */
+	static constexpr uint8_t idIndex(uint8_t id){
+		return id;
+	}
+
+	/***
+	 * MetricSource index of a core count
+	 * @param core
+	 * @return
+	 */
+	static constexpr uint8_t coreIndex(uint8_t core){
+		return IDS + core;
+	}
+
+	/***
+	 * One count from a consistent snapshot
+	 * @param index - from idIndex or coreIndex
+	 * @return 0 if out of range
+	 */
+	virtual uint32_t read(uint8_t index) const {
+		Snapshot snap;
+		snapshot(snap);
+		if (index < IDS){
+			return snap.xIds[index];
+		}
+		if (index < IDS + CORES){
+			return snap.xCores[index - IDS];
+		}
+		return 0;
+	}
+
+	/***
+	 * Count one event for id on the calling core
+	 * @param id
+	 */
+	void inc(uint8_t id){
+		uint32_t irq = save_and_disable_interrupts();
+		uint8_t core = get_core_num();
+		add(core, id, core);
+		restore_interrupts(irq);
+	}
+
+	/***
+	 * Count one event for id against a named core
+	 * @param id
+	 * @param core
+	 */
+	void incCore(uint8_t id, uint8_t core){
+		uint32_t irq = save_and_disable_interrupts();
+		add(get_core_num(), id, core);
+		restore_interrupts(irq);
+	}
+
+	/***
+	 * Take a consistent copy, callable from any core or an interrupt
+	 * @param snap
+	 */
+	void snapshot(Snapshot &snap) const {
+		for (uint8_t i = 0; i < IDS; i++){
+			snap.xIds[i] = 0;
+		}
+		for (uint8_t c = 0; c < CORES; c++){
+			snap.xCores[c] = 0;
+		}
+
+		for (uint8_t s = 0; s < CORES; s++){
+			const Shard &shard = xShards[s];
+			uint32_t ids[IDS];
+			uint32_t cores[CORES];
+			uint32_t seq;
+			do {
+				seq = shard.xSeq;
+				__dmb();
+				for (uint8_t i = 0; i < IDS; i++){
+					ids[i] = shard.xIds[i];
+				}
+				for (uint8_t c = 0; c < CORES; c++){
+					cores[c] = shard.xCores[c];
+				}
+				__dmb();
+			} while ((seq & 1) || (seq != shard.xSeq));
+
+			for (uint8_t i = 0; i < IDS; i++){
+				snap.xIds[i] += ids[i];
+			}
+			for (uint8_t c = 0; c < CORES; c++){
+				snap.xCores[c] += cores[c];
+			}
+		}
+	}
+
+private:
+	struct alignas(SHARD_ALIGN) Shard {
+		volatile uint32_t xSeq;
+		volatile uint32_t xIds[IDS];
+		volatile uint32_t xCores[CORES];
+	};
+
+	/***
+	 * Update the shard of this core, interrupts must be masked
+	 */
+	void add(uint8_t shard, uint8_t id, uint8_t core){
+		if ((shard >= CORES) || (id >= IDS)){
+			return;
+		}
+		Shard &s = xShards[shard];
+		s.xSeq = s.xSeq + 1;
+		__dmb();
+		s.xIds[id] = s.xIds[id] + 1;
+		if (core < CORES){
+			s.xCores[core] = s.xCores[core] + 1;
+		}
+		__dmb();
+		s.xSeq = s.xSeq + 1;
+	}
+
+	Shard xShards[CORES];
+};
+
+#endif /* EXP_2CORERTOS_SRC_SHARDEDCOUNTER_H_ */
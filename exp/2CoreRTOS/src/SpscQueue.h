@@ -0,0 +1,89 @@
+/*
+ * SpscQueue.h
+ *
+ * Bounded lock free single producer, single consumer ring.
+ * Safe between tasks on different cores as each index is only
+ * written by one side.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_SPSCQUEUE_H_
+#define EXP_2CORERTOS_SRC_SPSCQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template<typename T, size_t N>
+class SpscQueue {
+public:
+	static_assert((N & (N - 1)) == 0, "SpscQueue length must be a power of two");
+
+	/***
+	 * Add an item. Producer side only.
+	 * @param item
+	 * @return false if full
+	 */
+	bool push(const T &item){
+		uint32_t head = xHead.load(std::memory_order_relaxed);
+		uint32_t tail = xTail.load(std::memory_order_acquire);
+		if ((head - tail) >= N){
+			return false;
+		}
+		xItems[head & (N - 1)] = item;
+		xHead.store(head + 1, std::memory_order_release);
+
+		uint32_t depth = head + 1 - tail;
+		if (depth > xHighWater){
+			xHighWater = depth;
+		}
+		return true;
+	}
+
+	/***
+	 * Remove an item. Consumer side only.
+	 * @param item - filled in
+	 * @return false if empty
+	 */
+	bool pop(T &item){
+		uint32_t tail = xTail.load(std::memory_order_relaxed);
+		uint32_t head = xHead.load(std::memory_order_acquire);
+		if (head == tail){
+			return false;
+		}
+		item = xItems[tail & (N - 1)];
+		xTail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/***
+	 * Current occupancy, may be stale by the time it is used
+	 * @return
+	 */
+	uint32_t size() const {
+		return xHead.load(std::memory_order_acquire) -
+				xTail.load(std::memory_order_acquire);
+	}
+
+	/***
+	 * Largest occupancy seen by the producer
+	 * @return
+	 */
+	uint32_t highWater() const {
+		return xHighWater;
+	}
+
+	constexpr size_t capacity() const {
+		return N;
+	}
+
+private:
+	std::atomic<uint32_t> xHead = 0;
+	std::atomic<uint32_t> xTail = 0;
+	uint32_t xHighWater = 0;
+	T xItems[N];
+};
+
+#endif /* EXP_2CORERTOS_SRC_SPSCQUEUE_H_ */
@@ -0,0 +1,41 @@
+/*
+ * StackBudgets.h
+ *
+ * Stack in words for each kind of Agent, used through STACK_BUDGET in
+ * getMaxStackSize.
+ *
+ * tools/stack_budget.py --write regenerates the values from a
+ * PICALC_STACK_CALIBRATE build and run: the deeper of the static call
+ * graph from run() and the painted high water, plus margin. Regenerate
+ * rather than edit. The line at the top of the namespace says where the
+ * current values came from.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_STACKBUDGETS_H_
+#define EXP_2CORERTOS_SRC_STACKBUDGETS_H_
+
+#include "FreeRTOS.h"
+
+namespace StackBudgets {
+
+//Seeded from the previous hard coded sizes, no calibration run yet
+constexpr configSTACK_DEPTH_TYPE AgentSupervisor  = 512;
+constexpr configSTACK_DEPTH_TYPE ComputeStage     = 5000;
+constexpr configSTACK_DEPTH_TYPE ExecutorBench    = 1024;
+constexpr configSTACK_DEPTH_TYPE ExecutorCore     = 1024;
+constexpr configSTACK_DEPTH_TYPE FairnessMonitor  = 512;
+constexpr configSTACK_DEPTH_TYPE MigrationMonitor = 512;
+constexpr configSTACK_DEPTH_TYPE NoiseAgent       = 512;
+constexpr configSTACK_DEPTH_TYPE PublishStage     = 1024;
+constexpr configSTACK_DEPTH_TYPE Reporter         = 512;
+constexpr configSTACK_DEPTH_TYPE TSTAgent         = 256;
+constexpr configSTACK_DEPTH_TYPE TSTMetrics       = 1024;
+constexpr configSTACK_DEPTH_TYPE VerifyStage      = 1024;
+constexpr configSTACK_DEPTH_TYPE Worker           = 5000;
+
+}
+
+#endif /* EXP_2CORERTOS_SRC_STACKBUDGETS_H_ */
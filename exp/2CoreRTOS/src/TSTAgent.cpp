@@ -7,6 +7,10 @@
 
 #include "TSTAgent.h"
 #include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "TextBuffer.h"
+#include "ScopeTimer.h"
+#include <cstdio>
 
 #define DEBUG_LINE 15
 
@@ -25,41 +29,146 @@ TSTAgent::~TSTAgent() {
 }
 
 
-void TSTAgent::run(){
-	UBaseType_t uxCoreAffinityMask;
-	uxCoreAffinityMask = ( ( 1 << 0 ) );
-	vTaskCoreAffinitySet( xHandle, uxCoreAffinityMask );
+TSTAgent *TSTAgent::pUartAgent = NULL;
+
+void TSTAgent::setCore(int8_t core){
+	xCore = core;
+}
 
-	char buf[25];
+void TSTAgent::run(){
+	if (xCore != TST_ANY_CORE){
+		UBaseType_t uxCoreAffinityMask;
+		uxCoreAffinityMask = ( ( 1 << xCore ) );
+		vTaskCoreAffinitySet( xHandle, uxCoreAffinityMask );
+	}
 
 	size_t read = 0;
 	tstInit(&TST_Device);
+	enableRxWake();
 
 	for (;;){
+		heartbeat();
+
+		//Forget a request that was never answered or never completed
+		if (xArrived && ((time_us_32() - xArrivalUs) > (TST_RESPONSE_MS * 1000))){
+			xArrived = false;
+			xInFlight = false;
+		}
 
 		read = readData( rxData,  TSTMAXSIZE);
 		if (read > 0) {
+			//Data found by polling before the wake stamped it, or the
+			//start of the next request after an unanswered one
+			if (!xArrived || xInFlight){
+				xArrivalUs = time_us_32();
+				xArrived = true;
+				xInFlight = false;
+			}
 			//debugPrintBuffer( "Read",   rxData,  read);
-			uint8_t err = tstRx(TST_Device.name, TST_Interface.interface, rxData, read);
+			uint8_t err;
+			{
+				SCOPE_TIMER("tstRx");
+				err = tstRx(TST_Device.name, TST_Interface.interface, rxData, read);
+			}
 			if (err != TST_OK){
-				char errTxt[10];
-				sprintf(errTxt,"Error: %u", err);
+				char errTxt[12];
+				TextBuffer text(errTxt, sizeof(errTxt));
+				text.add("Error: ").addUnsigned(err);
 				tstMonitorSend(TST_Device.name, TST_Interface.interface, errTxt);
+				xArrived = false;
+			} else {
+				xInFlight = rxDrained(read);
 			}
 		}
 
 		//tstMonitorSend(TST_Device.name, TST_Interface.interface, "TST Device alive");
-		if (tstTx(TST_Device.name, TST_Interface.interface, txData, &txSize) == TST_OK && txSize > 0) {
+		uint8_t txErr;
+		{
+			SCOPE_TIMER("tstTx");
+			txErr = tstTx(TST_Device.name, TST_Interface.interface, txData, &txSize);
+		}
+		if (txErr == TST_OK && txSize > 0) {
 			writeData( txData, txSize);
+			//First transmission after a complete request, in this pass or later
+			if (xInFlight){
+				recordLatency();
+			}
 		}
 
-		vTaskDelay(pdMS_TO_TICKS(10));
+		//Sleep until a request arrives, waking anyway to flush monitor traffic
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TST_POLL_MS));
+	}
+}
+
+const Histogram *TSTAgent::getLatency(){
+	return &xLatency;
+}
+
+void TSTAgent::resetLatency(){
+	xLatency.reset();
+}
+
+void TSTAgent::recordLatency(){
+	xLatency.record(time_us_32() - xArrivalUs);
+	xArrived = false;
+	xInFlight = false;
+
+	TST_V.tstRequests = xLatency.getCount();
+	TST_V.tstLatP50 = xLatency.percentile(500);
+	TST_V.tstLatP99 = xLatency.percentile(990);
+	TST_V.tstLatMax = xLatency.getMax();
+}
+
+bool TSTAgent::rxDrained(size_t read){
+	if (read >= TSTMAXSIZE){
+		return false;
+	}
+	return (pUart == NULL) || (xRxQueue.size() == 0);
+}
+
+void TSTAgent::enableRxWake(){
+	if (pUart == NULL){
+		stdio_set_chars_available_callback(TSTAgent::charsAvailableCB, this);
+	} else {
+		pUartAgent = this;
+		unsigned int irq = UART0_IRQ + uart_get_index(pUart);
+		irq_set_exclusive_handler(irq, TSTAgent::uartIrq);
+		irq_set_enabled(irq, true);
+		uart_set_irq_enables(pUart, true, false);
+	}
+}
+
+void TSTAgent::rxArrived(){
+	if (!xArrived){
+		xArrivalUs = time_us_32();
+		xArrived = true;
+	}
+	if (xHandle != NULL){
+		BaseType_t woken = pdFALSE;
+		vTaskNotifyGiveFromISR(xHandle, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
 
+void TSTAgent::uartIrq(){
+	TSTAgent *agent = pUartAgent;
+	if (agent == NULL){
+		return;
 	}
+	while (uart_is_readable(agent->pUart)){
+		//Drop bytes if the task has fallen this far behind
+		agent->xRxQueue.push((uint8_t)uart_getc(agent->pUart));
+	}
+	agent->rxArrived();
+}
+
+void TSTAgent::charsAvailableCB(void *param){
+	((TSTAgent *)param)->rxArrived();
 }
 
 
 size_t TSTAgent::readData(uint8_t *buf, size_t max){
+	SCOPE_TIMER("TSTAgent::readData");
 	size_t res = 0;
 	if (pUart == NULL){
 		while (res < max) {
@@ -68,22 +177,16 @@ size_t TSTAgent::readData(uint8_t *buf, size_t max){
 			buf[res++] = (uint8_t)c;
 		}
 	} else {
-		for (int i = 0; i < 5; i++ ){
-			while (uart_is_readable ( pUart)){
-				buf[res] = uart_getc ( pUart);
-				res++;
-				if (res >= max){
-					break;
-				}
-
-			}
-			vTaskDelay(pdMS_TO_TICKS(10));
+		uint8_t c;
+		while ((res < max) && xRxQueue.pop(c)){
+			buf[res++] = c;
 		}
 	}
 	return res;
 }
 
 void TSTAgent::writeData(uint8_t *buf, size_t length){
+	SCOPE_TIMER("TSTAgent::writeData");
 	if (pUart == NULL){
 		 fwrite(buf, 1, length, stdout);
 		 fflush(stdout);
@@ -99,7 +202,7 @@ void TSTAgent::writeData(uint8_t *buf, size_t length){
  * @return - words
  */
 configSTACK_DEPTH_TYPE TSTAgent::getMaxStackSize(){
-	return 256;
+	return STACK_BUDGET(TSTAgent);
 }
 
 
@@ -107,40 +210,43 @@ void TSTAgent::debugPrintBuffer(const char *title, const void * pBuffer, size_t
 	size_t count =0;
 	size_t lineEnd=0;
 	const uint8_t *pBuf = (uint8_t *)pBuffer;
+	char line[DEBUG_LINE * 4 + 2];
+	TextBuffer text(line, sizeof(line));
 
-	printf("DEBUG: %s of size %d\n", title, bytes);
+	fputs("DEBUG: ", stdout);
+	fputs(title, stdout);
+	text.add(" of size ").addUnsigned(bytes).add('\n');
+	fputs(text.c_str(), stdout);
 
 	while (count < bytes){
 		lineEnd = count + DEBUG_LINE;
 		if (lineEnd > bytes){
 			lineEnd = bytes;
 		}
+		text.clear();
 
-		//Print HEX DUMP
+		//HEX DUMP
 		for (size_t i=count; i < lineEnd; i++){
-			if (pBuf[i] <= 0x0F){
-				printf("0%X ", pBuf[i]);
-			} else {
-				printf("%X ", pBuf[i]);
-			}
+			text.addHex(pBuf[i], 2).add(' ');
 		}
 
 		//Pad for short lines
 		size_t pad = (DEBUG_LINE - (lineEnd - count)) * 3;
 		for (size_t i=0; i < pad; i++){
-			printf(" ");
+			text.add(' ');
 		}
 
-		//Print Plain Text
+		//Plain Text
 		for (size_t i=count; i < lineEnd; i++){
 			if ((pBuf[i] >= 0x20) && (pBuf[i] <= 0x7e)){
-				printf("%c", pBuf[i]);
+				text.add((char)pBuf[i]);
 			} else {
-				printf(".");
+				text.add('.');
 			}
 		}
 
-		printf("\n");
+		text.add('\n');
+		fputs(text.c_str(), stdout);
 
 		count = lineEnd;
 
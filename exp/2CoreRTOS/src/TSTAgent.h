@@ -1,6 +1,16 @@
 /*
  * TSTAgent.h
  *
+ * TST comms service. Sleeps until received data wakes it, so with a
+ * priority above the Workers a request is serviced without waiting
+ * for a time slice. Times each request from its first byte arriving
+ * to the response being written.
+ *
+ * A request is complete once tstRx has taken it and nothing more is
+ * waiting to be read. The first transmission after that is its
+ * response, anything sent while a request is still arriving is
+ * monitor traffic.
+ *
  *  Created on: 28 Jun 2025
  *      Author: jondurrant
  */
@@ -9,6 +19,8 @@
 #define EXP_2CORERTOS_SRC_TSTAGENT_H_
 
 #include "Agent.h"
+#include "Histogram.h"
+#include "SpscQueue.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
 extern "C"{
@@ -19,6 +31,11 @@ extern "C"{
 #include "pico/stdio.h"
 #include "hardware/uart.h"
 
+#define TST_ANY_CORE		-1
+#define TST_POLL_MS			10		//Longest wait for outgoing monitor traffic
+#define TST_RX_QUEUE		512		//UART bytes buffered by the RX interrupt
+#define TST_RESPONSE_MS		1000	//Request abandoned if not answered by then
+
 class TSTAgent  : public Agent {
 public:
 	TSTAgent();
@@ -27,6 +44,24 @@ public:
 
 	void debugPrintBuffer(const char *title, const void * pBuffer, size_t bytes);
 
+	/***
+	 * Core the comms task is pinned to, applied when the task starts
+	 * @param core - 0, 1 or TST_ANY_CORE. Default 0
+	 */
+	void setCore(int8_t core);
+
+	/***
+	 * Time from the first byte of a request arriving to the response
+	 * being written, in us
+	 * @return
+	 */
+	const Histogram *getLatency();
+
+	/***
+	 * Clear latency stats. Only call while no requests are in flight.
+	 */
+	void resetLatency();
+
 protected:
 	/***
 	 * Task main run loop
@@ -46,12 +81,46 @@ private:
 	size_t readData(uint8_t *buf, size_t max);
 	void writeData(uint8_t *buf, size_t length);
 
+	/***
+	 * Hook the receive side so arriving data wakes the task
+	 */
+	void enableRxWake();
+
+	/***
+	 * Note the first byte of a request and wake the task. Interrupt context.
+	 */
+	void rxArrived();
+
+	/***
+	 * Record a serviced request and publish to TST_V
+	 */
+	void recordLatency();
+
+	/***
+	 * Has everything received so far been read
+	 * @param read - bytes from the last readData
+	 * @return
+	 */
+	bool rxDrained(size_t read);
+
+	static void uartIrq();
+	static void charsAvailableCB(void *param);
+
 	uint8_t rxData[TSTMAXSIZE];
 	size_t rxSize = 0;
 	uint8_t txData[TSTMAXSIZE];
 	size_t txSize = 0;
 
 	uart_inst_t * pUart = NULL;
+	int8_t xCore = 0;
+
+	SpscQueue<uint8_t, TST_RX_QUEUE> xRxQueue;
+	volatile uint32_t xArrivalUs = 0;
+	volatile bool xArrived = false;
+	bool xInFlight = false;		//Complete request waiting for its response
+	Histogram xLatency;
+
+	static TSTAgent *pUartAgent;
 };
 
 #endif /* EXP_2CORERTOS_SRC_TSTAGENT_H_ */
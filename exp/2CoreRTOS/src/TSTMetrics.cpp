@@ -7,6 +7,7 @@
 
 #include "TSTMetrics.h"
 #include "Counter.h"
+#include "TextBuffer.h"
 
 TSTMetrics::TSTMetrics() {
 	// TODO Auto-generated constructor stub
@@ -17,20 +18,125 @@ TSTMetrics::~TSTMetrics() {
 	// TODO Auto-generated destructor stub
 }
 
+void TSTMetrics::setCpuMonitor(CpuMonitor *cpu){
+	pCpu = cpu;
+}
+
+void TSTMetrics::setProfiler(Profiler *profiler){
+	pProfiler = profiler;
+}
+
 void TSTMetrics::run(){
+	uint32_t loops = 0;
 	for (;;){
+		heartbeat();
 
-		// Update TST_V with system/monitoring variables
-		uint32_t c0, c1;
-		Counter::getInstance()->getCores(c0, c1);
-		TST_V.core0Count = c0;
-		TST_V.core1Count = c1;
+		//Percentiles walk the histograms, once a second is enough
+		if ((loops++ % 10) == 0){
+			publishMetrics();
+			describeMetric();
+			describeScope();
+			if (pCpu != NULL){
+				pCpu->sample();
+			}
+		}
+
+		if (pProfiler != NULL){
+			pProfiler->flush(pCpu);
+		}
 
 		vTaskDelay(pdMS_TO_TICKS(100));
 	}
 
 }
 
+void TSTMetrics::publishMetrics(){
+	MetricRegistry *registry = MetricRegistry::getInstance();
+	uint32_t values[TST_METRIC_SLOTS];
+	uint8_t slots = registry->getSlots();
+
+	if (xNextSlot >= slots){
+		xNextSlot = 0;
+	}
+	uint8_t first = xNextSlot;
+	uint8_t count = registry->read(first, values, TST_METRIC_SLOTS);
+
+	//Marked empty while the values change so a torn page is visible
+	TST_V.metrics.count = 0;
+	for (uint8_t i = 0; i < count; i++){
+		TST_V.metrics.values[i] = values[i];
+	}
+	TST_V.metrics.slots = slots;
+	TST_V.metrics.first = first;
+	TST_V.metrics.seq = ++xSeq;
+	TST_V.metrics.count = count;
+
+	xNextSlot = first + count;
+}
+
+void TSTMetrics::describeMetric(){
+	MetricRegistry *registry = MetricRegistry::getInstance();
+	uint8_t count = registry->getCount();
+	if (count == 0){
+		return;
+	}
+	if (xNextMetric >= count){
+		xNextMetric = 0;
+	}
+	const MetricRegistry::Metric *m = registry->get(xNextMetric++);
+	if (m == NULL){
+		return;
+	}
+
+	char line[64];
+	TextBuffer text(line, sizeof(line));
+	text.add("Metric ").addUnsigned(m->xSlot)
+		.add(' ').add(MetricRegistry::typeName(m->xType))
+		.add(' ').add(m->pName);
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+}
+
+void TSTMetrics::describeScope(){
+	if (pNextScope == NULL){
+		pNextScope = ScopeSite::first();
+		if (pNextScope == NULL){
+			return;
+		}
+	}
+	ScopeSite *site = pNextScope;
+	pNextScope = site->next();
+
+	ScopeSite::Stats total = {0, UINT32_MAX, 0, 0, 0};
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		ScopeSite::Stats stats = site->get(c);
+		total.xCount += stats.xCount;
+		total.xTotal += stats.xTotal;
+		total.xDropped += stats.xDropped;
+		if (stats.xMin < total.xMin){
+			total.xMin = stats.xMin;
+		}
+		if (stats.xMax > total.xMax){
+			total.xMax = stats.xMax;
+		}
+	}
+	if ((total.xCount == 0) && (total.xDropped == 0)){
+		return;
+	}
+	if (total.xCount == 0){
+		total.xMin = 0;
+	}
+
+	char line[96];
+	TextBuffer text(line, sizeof(line));
+	text.add("Scope ").add(site->getName())
+		.add(' ').addUnsigned(total.xCount)
+		.add(' ').addUnsigned((total.xCount > 0) ? total.xTotal / total.xCount : 0)
+		.add(' ').addUnsigned(total.xMin)
+		.add(' ').addUnsigned(total.xMax)
+		.add(' ').addUnsigned(total.xDropped);
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+}
+
 configSTACK_DEPTH_TYPE TSTMetrics::getMaxStackSize(){
-	return 1024;
+	return STACK_BUDGET(TSTMetrics);
 }
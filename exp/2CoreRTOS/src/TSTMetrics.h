@@ -9,6 +9,10 @@
 #define EXP_FREERTOSMETRICS_SRC_TSTMETRICS_H_
 
 #include "Agent.h"
+#include "MetricRegistry.h"
+#include "CpuMonitor.h"
+#include "Profiler.h"
+#include "ScopeTimer.h"
 #include "pico/stdlib.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
@@ -21,6 +25,18 @@ public:
 	TSTMetrics();
 	virtual ~TSTMetrics();
 
+	/***
+	 * Sample CPU use once a second
+	 * @param cpu - NULL for none
+	 */
+	void setCpuMonitor(CpuMonitor *cpu);
+
+	/***
+	 * Send profiler samples every update
+	 * @param profiler - NULL for none
+	 */
+	void setProfiler(Profiler *profiler);
+
 protected:
 	/***
 	 * Task main run loop
@@ -34,7 +50,31 @@ protected:
 	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
 
 private:
-	char stats_buffer[1024];
+	/***
+	 * Fill TST_V.metrics with the next run of registry slots. When more
+	 * slots are registered than the page holds it steps through them.
+	 */
+	void publishMetrics();
+
+	/***
+	 * Send the next "Metric slot type name" descriptor to the TST
+	 * monitor, cycling through the registry so a late host still
+	 * learns what each slot holds.
+	 */
+	void describeMetric();
+
+	/***
+	 * Send the next "Scope name count avg min max dropped" line to the TST
+	 * monitor, cycling through the scope timer sites, cores combined
+	 */
+	void describeScope();
+
+	CpuMonitor *pCpu = NULL;
+	Profiler *pProfiler = NULL;
+	uint8_t xNextSlot = 0;
+	uint8_t xNextMetric = 0;
+	ScopeSite *pNextScope = NULL;
+	uint8_t xSeq = 0;
 };
 
 #endif /* EXP_FREERTOSMETRICS_SRC_TSTMETRICS_H_ */
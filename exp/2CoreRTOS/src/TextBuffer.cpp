@@ -0,0 +1,119 @@
+/*
+ * TextBuffer.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TextBuffer.h"
+
+TextBuffer::TextBuffer(char *buf, size_t size) {
+	pBuf = buf;
+	xSize = size;
+	clear();
+}
+
+void TextBuffer::clear(){
+	xLen = 0;
+	xTruncated = false;
+	if (xSize > 0){
+		pBuf[0] = 0;
+	}
+}
+
+TextBuffer &TextBuffer::add(char c){
+	if (xLen + 1 < xSize){
+		pBuf[xLen++] = c;
+		pBuf[xLen] = 0;
+	} else {
+		xTruncated = true;
+	}
+	return *this;
+}
+
+TextBuffer &TextBuffer::add(const char *s){
+	while (*s != 0){
+		add(*s++);
+	}
+	return *this;
+}
+
+TextBuffer &TextBuffer::add(const char *s, uint8_t width){
+	size_t start = xLen;
+	add(s);
+	for (size_t i = xLen - start; i < width; i++){
+		add(' ');
+	}
+	return *this;
+}
+
+TextBuffer &TextBuffer::addUnsigned(uint64_t value, uint8_t width, char pad){
+	char digits[20];
+	uint8_t n = 0;
+	do {
+		digits[n++] = (char)('0' + (value % 10));
+		value /= 10;
+	} while (value != 0);
+	for (uint8_t i = n; i < width; i++){
+		add(pad);
+	}
+	while (n > 0){
+		add(digits[--n]);
+	}
+	return *this;
+}
+
+TextBuffer &TextBuffer::addSigned(int64_t value, uint8_t width){
+	uint64_t mag = (value < 0) ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+	uint8_t n = 1;
+	for (uint64_t v = mag; v >= 10; v /= 10){
+		n++;
+	}
+	if (value < 0){
+		n++;
+	}
+	for (uint8_t i = n; i < width; i++){
+		add(' ');
+	}
+	if (value < 0){
+		add('-');
+	}
+	return addUnsigned(mag);
+}
+
+TextBuffer &TextBuffer::addFixed(int64_t value, uint8_t decimals){
+	uint64_t scale = 1;
+	for (uint8_t i = 0; i < decimals; i++){
+		scale *= 10;
+	}
+	uint64_t mag = (value < 0) ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+	if (value < 0){
+		add('-');
+	}
+	addUnsigned(mag / scale);
+	if (decimals > 0){
+		add('.');
+		addUnsigned(mag % scale, decimals, '0');
+	}
+	return *this;
+}
+
+TextBuffer &TextBuffer::addHex(uint32_t value, uint8_t digits){
+	static const char hex[] = "0123456789ABCDEF";
+	for (int8_t i = digits - 1; i >= 0; i--){
+		add(hex[(value >> (i * 4)) & 0xF]);
+	}
+	return *this;
+}
+
+const char *TextBuffer::c_str() const {
+	return pBuf;
+}
+
+size_t TextBuffer::length() const {
+	return xLen;
+}
+
+bool TextBuffer::isTruncated() const {
+	return xTruncated;
+}
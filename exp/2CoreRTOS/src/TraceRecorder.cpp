@@ -0,0 +1,216 @@
+/*
+ * TraceRecorder.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TraceRecorder.h"
+#include "Agent.h"
+#include "AgentRegistry.h"
+#include "CycleClock.h"
+#include "TextBuffer.h"
+#include "task.h"
+#include "timers.h"
+
+TraceRecorder::TraceRecorder() {
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xStartHead[c] = 0;
+		xStopHead[c] = 0;
+		xStartSwitches[c] = 0;
+		xStopSwitches[c] = 0;
+	}
+}
+
+TraceRecorder::~TraceRecorder() {
+	// NOP
+}
+
+void TraceRecorder::start(){
+#if TRACE_RECORDER
+	CycleClock::Stamp stamp;
+
+	//Time the hooks as the kernel expands them. Switching this task out
+	//and back in on its own core only restarts its slice. The events
+	//are overwritten as the ring wraps.
+	uint32_t irq = save_and_disable_interrupts();
+	CycleClock::start(stamp);
+	for (uint32_t i = 0; i < TRACE_CALIBRATE; i++){
+		traceQUEUE_SEND(&stamp);
+	}
+	xCostNs = CycleClock::elapsedNs(stamp) / TRACE_CALIBRATE;
+
+	CycleClock::start(stamp);
+	for (uint32_t i = 0; i < TRACE_CALIBRATE; i++){
+		traceTASK_SWITCHED_OUT();
+		traceTASK_SWITCHED_IN();
+	}
+	xSwitchNs = CycleClock::elapsedNs(stamp) / TRACE_CALIBRATE;
+
+	//What the notrace build still pays at each switch
+	vTraceRecorderEnable(0);
+	CycleClock::start(stamp);
+	for (uint32_t i = 0; i < TRACE_CALIBRATE; i++){
+		traceTASK_SWITCHED_IN();
+	}
+	xBaseNs = CycleClock::elapsedNs(stamp) / TRACE_CALIBRATE;
+	vTraceRecorderEnable(1);
+	restore_interrupts(irq);
+
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		xStartHead[c] = ulTraceEventHead[c];
+		xStartSwitches[c] = ulTraceSwitches[c];
+	}
+	xStartUs = time_us_64();
+	xStopUs = 0;
+#endif
+}
+
+void TraceRecorder::stop(){
+#if TRACE_RECORDER
+	vTraceRecorderEnable(0);
+	if (xStopUs == 0){
+		xStopUs = time_us_64();
+		for (uint8_t c = 0; c < MAX_CORES; c++){
+			xStopHead[c] = ulTraceEventHead[c];
+			xStopSwitches[c] = ulTraceSwitches[c];
+		}
+	}
+#endif
+}
+
+void TraceRecorder::report(Counter *counter){
+#if TRACE_RECORDER
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	if (xStartUs == 0){
+		return;
+	}
+	uint64_t stopUs = (xStopUs == 0) ? time_us_64() : xStopUs;
+	uint64_t periodUs = stopUs - xStartUs;
+	if (periodUs == 0){
+		return;
+	}
+
+	text.add("Trace ns: switch ").addUnsigned(xSwitchNs)
+		.add(" event ").addUnsigned(xCostNs)
+		.add(" base switch ").addUnsigned(xBaseNs).add("\n\r");
+	counter->print(text.c_str());
+	counter->print("Core\tSwitch/s\tEvents/s\tOverhead\tBase\n\r");
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		uint32_t head = (xStopUs == 0) ? ulTraceEventHead[c] : xStopHead[c];
+		uint32_t switched = (xStopUs == 0) ? ulTraceSwitches[c] : xStopSwitches[c];
+		uint64_t events = head - xStartHead[c];
+		uint64_t switches = switched - xStartSwitches[c];
+
+		//Each switch records an out and an in event, cost in xSwitchNs
+		uint64_t others = (events > switches * 2) ? events - switches * 2 : 0;
+		uint64_t ns = switches * xSwitchNs + others * xCostNs;
+
+		//Per mille of the core, ns against us x 1000
+		text.clear();
+		text.addUnsigned(c)
+			.add('\t').addUnsigned((switches * 1000000) / periodUs)
+			.add("\t\t").addUnsigned((events * 1000000) / periodUs)
+			.add("\t\t").addFixed(ns / periodUs, 1)
+			.add("%\t\t").addFixed((switches * xBaseNs) / periodUs, 1)
+			.add("%\n\r");
+		counter->print(text.c_str());
+	}
+#else
+	counter->print("Trace recorder not built\n\r");
+#endif
+}
+
+void TraceRecorder::dump(Counter *counter){
+#if TRACE_RECORDER
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	stop();
+	//Let an event being written on the other core land
+	vTaskDelay(1);
+
+	text.add("TRACE begin cores=").addUnsigned(MAX_CORES)
+		.add(" events=").addUnsigned(TRACE_EVENTS_LEN)
+		.add(" cost_ns=").addUnsigned(xCostNs).add("\n\r");
+	counter->print(text.c_str());
+	dumpNames(counter);
+	for (uint8_t c = 0; c < MAX_CORES; c++){
+		dumpCore(counter, c);
+	}
+	counter->print("TRACE end\n\r");
+#endif
+}
+
+void TraceRecorder::dumpNames(Counter *counter){
+	char line[80];
+	TextBuffer text(line, sizeof(line));
+
+	//Agents are numbered by registry slot
+	for (uint8_t s = 0; s < AgentRegistry::getSlots(); s++){
+		Agent *agent = AgentRegistry::getAgent(s);
+		if (agent == NULL){
+			continue;
+		}
+		text.clear();
+		text.add("TRACE task=").addUnsigned(s + 1)
+			.add(" name=").add(agent->getName()).add("\n\r");
+		counter->print(text.c_str());
+	}
+
+	//Idle, timer and main, numbered by CpuMonitor
+	TaskHandle_t others[] = {
+		xTaskGetIdleTaskHandleForCore(0),
+		xTaskGetIdleTaskHandleForCore(1),
+		xTimerGetTimerDaemonTaskHandle(),
+		xTaskGetCurrentTaskHandle()
+	};
+	for (TaskHandle_t handle : others){
+		if (handle == NULL){
+			continue;
+		}
+		UBaseType_t number = uxTaskGetTaskNumber(handle);
+		if ((number <= AGENT_REGISTRY_MAX) || (number >= TRACE_MAX_TASKS)){
+			continue;
+		}
+		text.clear();
+		text.add("TRACE task=").addUnsigned(number)
+			.add(" name=").add(pcTaskGetName(handle)).add("\n\r");
+		counter->print(text.c_str());
+	}
+}
+
+void TraceRecorder::dumpCore(Counter *counter, uint8_t core){
+#if TRACE_RECORDER
+	char line[16 * TRACE_LINE_EVENTS + 16];
+	TextBuffer text(line, sizeof(line));
+
+	uint32_t head = ulTraceEventHead[core];
+	uint32_t count = (head < TRACE_EVENTS_LEN) ? head : TRACE_EVENTS_LEN;
+	uint32_t first = head - count;
+
+	text.add("TRACE core=").addUnsigned(core)
+		.add(" first=").addUnsigned(first)
+		.add(" count=").addUnsigned(count).add("\n\r");
+	counter->print(text.c_str());
+
+	//Each event as 16 hex digits: time, type, task, arg
+	for (uint32_t i = 0; i < count; i++){
+		if ((i % TRACE_LINE_EVENTS) == 0){
+			text.clear();
+			text.add("TRACE E ").addUnsigned(core).add(' ');
+		}
+		volatile TraceEvent_t *ev = &xTraceEvents[core][(first + i) & (TRACE_EVENTS_LEN - 1)];
+		text.addHex(ev->ulTimeUs, 8)
+			.addHex(ev->ucType, 2)
+			.addHex(ev->ucTask, 2)
+			.addHex(ev->usArg, 4);
+		if (((i % TRACE_LINE_EVENTS) == TRACE_LINE_EVENTS - 1) || (i == count - 1)){
+			text.add("\n\r");
+			counter->print(text.c_str());
+		}
+	}
+#endif
+}
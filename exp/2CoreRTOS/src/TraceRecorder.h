@@ -0,0 +1,88 @@
+/*
+ * TraceRecorder.h
+ *
+ * Front end to the scheduler event rings in traceHooks. Measures what
+ * the hooks cost, as the kernel expands them, and how many switches and
+ * events each core sees, so the overhead of leaving the recorder on is
+ * known. Prints the rings as TRACE lines for tools/trace_chrome.py.
+ *
+ * A context switch runs traceTASK_SWITCHED_OUT and traceTASK_SWITCHED_IN,
+ * including the task number lookups and the residency and migration
+ * accounting. That accounting is also in the notrace build, so it is
+ * reported apart as the base cost. Other events, queues, notifies and
+ * interrupts, cost about one traceQUEUE_SEND.
+ *
+ * Not an Agent, the calls are made from main_task and the alarm.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_TRACERECORDER_H_
+#define EXP_2CORERTOS_SRC_TRACERECORDER_H_
+
+#include "Counter.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "traceHooks.h"
+
+#define TRACE_CALIBRATE		256		//Events timed to find the cost of one
+#define TRACE_LINE_EVENTS	8		//Events per TRACE E line
+
+class TraceRecorder {
+public:
+	TraceRecorder();
+	virtual ~TraceRecorder();
+
+	/***
+	 * Time the hooks and start counting switches and events
+	 */
+	void start();
+
+	/***
+	 * Stop recording, the rings then hold the events up to now.
+	 * Safe from interrupts.
+	 */
+	void stop();
+
+	/***
+	 * Print the cost of each hook and the share of each core the hooks
+	 * took between start and stop, and how much of that remains with
+	 * the recorder not built
+	 * @param counter - used for output
+	 */
+	void report(Counter *counter);
+
+	/***
+	 * Print task names and both rings as TRACE lines, stopping
+	 * first if still recording
+	 * @param counter - used for output
+	 */
+	void dump(Counter *counter);
+
+private:
+	/***
+	 * Print task number to name for every numbered task
+	 * @param counter
+	 */
+	void dumpNames(Counter *counter);
+
+	/***
+	 * Print the events held for one core, oldest first
+	 * @param counter
+	 * @param core
+	 */
+	void dumpCore(Counter *counter, uint8_t core);
+
+	uint32_t xCostNs = 0;			//One traceQUEUE_SEND
+	uint32_t xSwitchNs = 0;			//Switch out and in, recording
+	uint32_t xBaseNs = 0;			//Switch in, not recording
+	uint32_t xStartHead[MAX_CORES];
+	uint32_t xStopHead[MAX_CORES];
+	uint32_t xStartSwitches[MAX_CORES];
+	uint32_t xStopSwitches[MAX_CORES];
+	uint64_t xStartUs = 0;
+	uint64_t xStopUs = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_TRACERECORDER_H_ */
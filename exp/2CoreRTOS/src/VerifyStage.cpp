@@ -0,0 +1,97 @@
+/*
+ * VerifyStage.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "VerifyStage.h"
+#include "ComputeStage.h"
+
+VerifyStage::VerifyStage(ResultMailbox *out) {
+	pOut = out;
+}
+
+VerifyStage::~VerifyStage() {
+	stop();
+}
+
+bool VerifyStage::addInput(PipelineLink *in){
+	if (xInputs >= VERIFY_MAX_INPUTS){
+		return false;
+	}
+	pIn[xInputs++] = in;
+	return true;
+}
+
+uint32_t VerifyStage::getErrors() const {
+	return xErrors;
+}
+
+uint32_t VerifyStage::getStalls() const {
+	return xStalls;
+}
+
+uint32_t VerifyStage::poolHighWater() const {
+	return xPool.highWater();
+}
+
+void VerifyStage::post(const ResultBlock &block){
+	MessagePtr<ResultBlock> msg = xPool.alloc();
+	if (!msg){
+		xStalls++;
+		while (!msg){
+			waitWake(1);
+			msg = xPool.alloc();
+		}
+	}
+	*msg = block;
+	if (!pOut->post(msg)){
+		xStalls++;
+		while (!pOut->post(msg)){
+			waitWake(1);
+		}
+	}
+}
+
+/***
+ * Task main run loop
+ */
+void VerifyStage::run(){
+	place();
+
+	//Reference checksum from a local calculation
+	ResultBlock ref;
+	ComputeStage::compute(ref);
+	xReference = ref.xChecksum;
+
+	ResultBlock block;
+	for (;;){
+		heartbeat();
+		bool idle = true;
+		for (uint8_t i = 0; i < xInputs; i++){
+			if (pIn[i]->pop(block)){
+				uint64_t start = time_us_64();
+				idle = false;
+				block.xValid = (block.xPrefix == VERIFY_PI_PREFIX) &&
+						(block.xChecksum == xReference);
+				if (!block.xValid){
+					xErrors = xErrors + 1;
+				}
+				account(start);
+				post(block);
+			}
+		}
+		if (idle){
+			waitWake(10);
+		}
+	}
+}
+
+/***
+ * Get the static depth required in words
+ * @return - words
+ */
+configSTACK_DEPTH_TYPE VerifyStage::getMaxStackSize(){
+	return STACK_BUDGET(VerifyStage);
+}
@@ -0,0 +1,82 @@
+/*
+ * VerifyStage.h
+ *
+ * Pipeline stage that checks result blocks from the compute stages.
+ * Checked blocks are taken from a pool and posted to the publish
+ * stage's mailbox, waiting while the pool or the mailbox is full.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_2CORERTOS_SRC_VERIFYSTAGE_H_
+#define EXP_2CORERTOS_SRC_VERIFYSTAGE_H_
+
+#include "PipelineStage.h"
+#include "MessagePool.h"
+
+#define VERIFY_MAX_INPUTS	4
+//Fills the mailbox with one block being published and one being checked
+#define VERIFY_POOL_LEN		(PIPELINE_QUEUE_LEN + 2)
+#define VERIFY_PI_PREFIX	31415926
+
+class VerifyStage : public PipelineStage {
+public:
+	VerifyStage(ResultMailbox *out);
+	virtual ~VerifyStage();
+
+	/***
+	 * Add an input link from a compute stage
+	 * @param in
+	 * @return false if no room
+	 */
+	bool addInput(PipelineLink *in);
+
+	/***
+	 * Blocks that failed verification
+	 * @return
+	 */
+	uint32_t getErrors() const;
+
+	/***
+	 * Number of times the pool was empty or the mailbox full
+	 * @return
+	 */
+	uint32_t getStalls() const;
+
+	/***
+	 * Blocks held by the mailbox or its owner at most
+	 * @return
+	 */
+	uint32_t poolHighWater() const;
+
+protected:
+	/***
+	 * Task main run loop
+	 */
+	virtual void run();
+
+	/***
+	 * Get the static depth required in words
+	 * @return - words
+	 */
+	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+
+private:
+	PipelineLink *pIn[VERIFY_MAX_INPUTS];
+	uint8_t xInputs = 0;
+	/***
+	 * Post a block to the output, waiting for a message and for room
+	 * @param block
+	 */
+	void post(const ResultBlock &block);
+
+	ResultMailbox *pOut;
+	MessagePool<ResultBlock, VERIFY_POOL_LEN> xPool;
+	uint32_t xStalls = 0;
+
+	uint32_t xReference = 0;
+	volatile uint32_t xErrors = 0;
+};
+
+#endif /* EXP_2CORERTOS_SRC_VERIFYSTAGE_H_ */
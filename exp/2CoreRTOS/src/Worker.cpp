@@ -7,6 +7,8 @@
 
 #include "Worker.h"
 #include "Counter.h"
+#include "CycleClock.h"
+#include "ScopeTimer.h"
 #include <pi_spigot/pi_spigot.h>
 
 Worker::Worker(uint8_t id) {
@@ -23,22 +25,71 @@ Worker::~Worker() {
  * Task main run loop
  */
 void Worker::run(){
-	for (;;){
+	CycleClock::Stamp stamp;
+	while (!isStopRequested()){
+		heartbeat();
+		if (!waitGate()){
+			break;
+		}
+		CycleClock::start(stamp);
 		if (doWork()){
+			uint32_t ns = CycleClock::elapsedNs(stamp);
 			Counter::getInstance()->inc(xId);
+			Counter::getInstance()->recordJob(xId, ns);
 		}
 	}
 }
 
+void Worker::setGate(EventGroupHandle_t gate, EventBits_t runBit,
+		EventBits_t parkedBit){
+	xRunBit = runBit;
+	xParkedBit = parkedBit;
+	xGate = gate;
+}
+
+uint8_t Worker::getId(){
+	return xId;
+}
+
+bool Worker::waitGate(){
+	if (xGate == NULL){
+		return true;
+	}
+	if (xEventGroupGetBits(xGate) & xRunBit){
+		return true;
+	}
+	xEventGroupSetBits(xGate, xParkedBit);
+	while (!isStopRequested()){
+		heartbeat();
+		EventBits_t bits = xEventGroupWaitBits(xGate, xRunBit, pdFALSE, pdTRUE,
+				pdMS_TO_TICKS(WORKER_GATE_POLL_MS));
+		if (bits & xRunBit){
+			xEventGroupClearBits(xGate, xParkedBit);
+			return true;
+		}
+	}
+	xEventGroupClearBits(xGate, xParkedBit);
+	return false;
+}
+
 /***
  * Get the static depth required in words
  * @return - words
  */
 configSTACK_DEPTH_TYPE Worker::getMaxStackSize(){
-	return 5000;
+	return STACK_BUDGET(Worker);
+}
+
+/***
+ * One PI calculation should never take this long
+ * @return ms
+ */
+uint32_t Worker::getStallTimeoutMs(){
+	return 10000;
 }
 
 bool Worker::doWork(){
+	SCOPE_TIMER("Worker::doWork");
 	using pi_spigot_type = math::constants::pi_spigot<1000, 9>;
 
 	using input_container_type  = std::vector<std::uint32_t>;
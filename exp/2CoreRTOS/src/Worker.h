@@ -10,6 +10,10 @@
 
 #include "Agent.h"
 #include "pico/stdlib.h"
+#include "event_groups.h"
+
+//Longest a gated worker waits before checking for a stop request
+#define WORKER_GATE_POLL_MS 100
 
 
 
@@ -18,6 +22,27 @@ public:
 	Worker(uint8_t id);
 	virtual ~Worker();
 
+	/***
+	 * Time without a heartbeat before the agent is treated as stalled
+	 * @return ms
+	 */
+	virtual uint32_t getStallTimeoutMs();
+
+	/***
+	 * Only work while the run bit is set. While waiting the worker
+	 * sets its parked bit so a controller knows it is idle.
+	 * @param gate - event group, NULL to run freely
+	 * @param runBit
+	 * @param parkedBit
+	 */
+	void setGate(EventGroupHandle_t gate, EventBits_t runBit, EventBits_t parkedBit);
+
+	/***
+	 * Id given at construction
+	 * @return
+	 */
+	uint8_t getId();
+
 protected:
 	/***
 	 * Task main run loop
@@ -33,8 +58,18 @@ protected:
 private:
 	bool doWork();
 
+	/***
+	 * Wait at the gate if there is one
+	 * @return false if stop was requested while waiting
+	 */
+	bool waitGate();
+
 	uint8_t xId;
 
+	EventGroupHandle_t xGate = NULL;
+	EventBits_t xRunBit = 0;
+	EventBits_t xParkedBit = 0;
+
 };
 
 
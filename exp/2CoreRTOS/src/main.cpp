@@ -12,29 +12,127 @@
 #include "Worker.h"
 #include "TSTAgent.h"
 #include "TSTMetrics.h"
+#include "Executor.h"
+#include "ExecutorBench.h"
+#include "ComputeStage.h"
+#include "VerifyStage.h"
+#include "PublishStage.h"
+#include "AgentSupervisor.h"
+#include "FairnessMonitor.h"
+#include "MigrationMonitor.h"
+#include "CpuMonitor.h"
+#include "NoiseAgent.h"
+#include "NoiseBench.h"
+#include "Reporter.h"
+#include "BenchHarness.h"
+#include "TraceRecorder.h"
+#include "Profiler.h"
+#include "ScopeTimer.h"
 #include "hardware/uart.h"
 
 
 
 #define TASK_PRIORITY      ( tskIDLE_PRIORITY + 1UL )
+//TST comms above every compute and monitor task so requests never queue
+//behind a time slice. It sleeps until data arrives so costs little.
+#define TST_PRIORITY       ( TASK_PRIORITY + 3UL )
 
 #define UART_ID uart0
 #define UART_TX_PIN 16
 #define UART_RX_PIN 17
 
+//Time allowed for a Worker to finish its current iteration after stop
+#define WORKER_JOIN_MS 5000
+
+//Set to 1 to measure Executor fork/join overhead instead of the PI workers
+#ifndef EXECUTOR_BENCH
+#define EXECUTOR_BENCH 0
+#endif
+
+//Set to 1 to run the compute, verify, publish pipeline instead of the PI workers
+#ifndef PIPELINE_MODE
+#define PIPELINE_MODE 0
+#endif
+
+//Set to 1 to measure Worker throughput under each kind of interference
+#ifndef NOISE_BENCH
+#define NOISE_BENCH 0
+#endif
+
+//Set to 1 to run repeated gated trials of the PI workers, see BenchHarness.h
+#ifndef TRIAL_BENCH
+#define TRIAL_BENCH 0
+#endif
+
+//Set to 1 to print the scheduler trace for tools/trace_chrome.py at the end
+#ifndef TRACE_DUMP
+#define TRACE_DUMP 0
+#endif
+
+//Set to 1 to stream PC samples for tools/profile.py, rate is PROFILER_HZ
+#ifndef PROFILE
+#define PROFILE 0
+#endif
+
+//Set by the PICALC_STACK_CALIBRATE build to print stack use at the end
+#ifndef STACK_CALIBRATE
+#define STACK_CALIBRATE 0
+#endif
+
 
 Worker worker1(0);
 Worker worker2(1);
 Worker worker3(2);
 Worker worker4(3);
-
-
+AgentSupervisor supervisor;
+FairnessMonitor fairness;
+MigrationMonitor migration;
+CpuMonitor cpu;
+TraceRecorder trace;
+Reporter reporter(UART_ID);
+
+#if NOISE_BENCH
+NoiseAgent noise;
+#endif
+
+#if EXECUTOR_BENCH
+ExecutorBench bench;
+#endif
+
+#if PIPELINE_MODE
+PipelineLink computeLink1;
+PipelineLink computeLink2;
+ComputeStage compute1(0, &computeLink1);
+ComputeStage compute2(1, &computeLink2);
+PublishStage publish;
+VerifyStage verify(publish.getMailbox());
+#endif
+
+
+TaskHandle_t mainTask = NULL;
+
+
+/***
+ * End of sample window, runs in alarm interrupt context.
+ * Freeze the counts, ask the workers to stop and leave formatting and
+ * output to the reporter. The trace stops here so it ends with the
+ * window.
+ */
 int64_t alarmCB (alarm_id_t id, void *user_data){
-	Counter::getInstance()->report();
-	worker1.stop();
-	worker2.stop();
-	worker3.stop();
-	worker4.stop();
+	BaseType_t woken = pdFALSE;
+	vTraceIsrEnter();
+	Counter::getInstance()->stop();
+	reporter.requestFromISR(&woken);
+	worker1.requestStopFromISR(&woken);
+	worker2.requestStopFromISR(&woken);
+	worker3.requestStopFromISR(&woken);
+	worker4.requestStopFromISR(&woken);
+	if (mainTask != NULL){
+		vTaskNotifyGiveFromISR(mainTask, &woken);
+	}
+	vTraceIsrExit();
+	trace.stop();
+	portYIELD_FROM_ISR(woken);
 	return 0;
 }
 
@@ -44,21 +142,141 @@ int64_t alarmCB (alarm_id_t id, void *user_data){
 
 void main_task(void* params){
 
+  mainTask = xTaskGetCurrentTaskHandle();
+
   TSTAgent tst;
   TSTMetrics metrics;
 
+#if !NOISE_BENCH && !TRIAL_BENCH
   alarm_id_t alarm = add_alarm_in_ms(
   			60 * 1000,
   			alarmCB, NULL, false);
-
-	Counter::getInstance(UART_ID)->start();
-	tst.start("TST", TASK_PRIORITY);
+#endif
+
+	reporter.start("Reporter", TASK_PRIORITY);
+	Counter::getInstance(UART_ID)->setReporter(&reporter);
+	Counter::getInstance()->start();
+	trace.start();
+	cpu.addTelemetry(&tst);
+	cpu.addTelemetry(&metrics);
+	cpu.addTelemetry(&supervisor);
+	cpu.addTelemetry(&migration);
+	cpu.addTelemetry(&fairness);
+	cpu.addTelemetry(&reporter);
+	metrics.setCpuMonitor(&cpu);
+#if PROFILE
+	metrics.setProfiler(Profiler::getInstance());
+	Profiler::getInstance()->start();
+#endif
+	tst.setCore(0);
+	tst.start("TST", TST_PRIORITY);
 	metrics.start("TXT Metrics",  TASK_PRIORITY);
+	supervisor.start("Supervisor", TASK_PRIORITY + 1);
+	migration.start("Migration", TASK_PRIORITY + 1);
+
+#if EXECUTOR_BENCH
+	Executor::getInstance()->start(TASK_PRIORITY + 1);
+	bench.start("Exec Bench", TASK_PRIORITY);
+	for (;;){
+		vTaskDelay(3000);
+	}
+#endif
+
+#if PIPELINE_MODE
+	computeLink1.connect(&compute1, &verify);
+	computeLink2.connect(&compute2, &verify);
+	verify.addInput(&computeLink1);
+	verify.addInput(&computeLink2);
+	publish.addStage(&compute1);
+	publish.addStage(&compute2);
+	publish.addStage(&verify);
+	publish.addStage(&publish);
+	publish.addLink(&computeLink1);
+	publish.addLink(&computeLink2);
+	publish.setVerifier(&verify);
+
+	compute1.setCore(0);
+	compute2.setCore(1);
+	verify.setCore(1);
+	publish.setCore(0);
+
+	publish.start("Publish", TASK_PRIORITY + 1);
+	verify.start("Verify", TASK_PRIORITY + 1);
+	compute1.start("Compute 1", TASK_PRIORITY);
+	compute2.start("Compute 2", TASK_PRIORITY);
+	for (;;){
+		vTaskDelay(3000);
+	}
+#endif
+
+#if TRIAL_BENCH
+	BenchHarness trialBench(Counter::getInstance());
+	trialBench.addWorker(&worker1);
+	trialBench.addWorker(&worker2);
+	trialBench.addWorker(&worker3);
+	trialBench.addWorker(&worker4);
+#endif
+
 	worker1.start("Worker 1", TASK_PRIORITY );
 	worker2.start("Worker 2", TASK_PRIORITY);
 	worker3.start("Worker 3", TASK_PRIORITY );
 	worker4.start("Worker 4", TASK_PRIORITY);
 
+	fairness.addWorker(&worker1);
+	fairness.addWorker(&worker2);
+	fairness.addWorker(&worker3);
+	fairness.addWorker(&worker4);
+	fairness.start("Fairness", TASK_PRIORITY + 2);
+
+#if NOISE_BENCH
+	noise.start("Noise", TASK_PRIORITY);
+	NoiseBench noiseBench(&noise, &tst, Counter::getInstance());
+	noiseBench.run();
+	worker1.requestStop();
+	worker2.requestStop();
+	worker3.requestStop();
+	worker4.requestStop();
+#elif TRIAL_BENCH
+	trialBench.run();
+	worker1.requestStop();
+	worker2.requestStop();
+	worker3.requestStop();
+	worker4.requestStop();
+#else
+	//Wait for the sample window to close
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#endif
+	worker1.join(pdMS_TO_TICKS(WORKER_JOIN_MS));
+	worker2.join(pdMS_TO_TICKS(WORKER_JOIN_MS));
+	worker3.join(pdMS_TO_TICKS(WORKER_JOIN_MS));
+	worker4.join(pdMS_TO_TICKS(WORKER_JOIN_MS));
+	fairness.requestStop();
+	fairness.join(pdMS_TO_TICKS(WORKER_JOIN_MS));
+#if NOISE_BENCH
+	reporter.request();
+#endif
+	fairness.report(Counter::getInstance());
+	migration.report(Counter::getInstance());
+	cpu.report(Counter::getInstance());
+	trace.report(Counter::getInstance());
+	ScopeSite::report(Counter::getInstance());
+#if PROFILE
+	Profiler::getInstance()->stop();
+	Profiler::getInstance()->report(Counter::getInstance());
+#endif
+#if NOISE_BENCH
+	noiseBench.report();
+#endif
+#if TRIAL_BENCH
+	trialBench.report();
+#endif
+#if TRACE_DUMP
+	trace.dump(Counter::getInstance());
+#endif
+#if STACK_CALIBRATE
+	supervisor.reportStacks(Counter::getInstance());
+#endif
+
   for (;;){
 	  vTaskDelay(3000);
   }
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Run the PICalc2Core build variant matrix and tabulate the results.
+
+Configure with -DPICALC_VARIANTS=ON and build; the build writes
+variants.csv listing every variant. For each variant this script can
+flash the board with picotool, capture the UART until the RESULT line
+and then print one comparison table against the base variant.
+
+Captured logs are kept as <logs>/<variant>.log so a table can be
+rebuilt later without the board:
+
+    bench_matrix.py build/variants.csv --port /dev/ttyUSB0 --flash
+    bench_matrix.py build/variants.csv --logs results --offline
+
+Jon Durrant - 2026
+"""
+
+import argparse
+import csv
+import os
+import re
+import subprocess
+import sys
+import time
+
+RESULT_RE = re.compile(r"RESULT\s+(.*)")
+
+
+def parse_result(line):
+    """Turn 'RESULT k=v k=v' into a dict, None if not a result line"""
+    m = RESULT_RE.search(line)
+    if m is None:
+        return None
+    fields = {}
+    for pair in m.group(1).split():
+        if "=" in pair:
+            k, v = pair.split("=", 1)
+            fields[k] = v
+    return fields
+
+
+def read_log(path):
+    """Last RESULT in a captured log"""
+    result = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            r = parse_result(line)
+            if r is not None:
+                result = r
+    return result
+
+
+def flash(uf2):
+    subprocess.run(["picotool", "load", "-x", "-f", uf2], check=True)
+
+
+def capture(port, baud, timeout, log_path):
+    """Read UART until a RESULT line or timeout, keeping a copy in log_path"""
+    import serial  # pyserial, only needed when talking to a board
+
+    result = None
+    deadline = time.time() + timeout
+    with serial.Serial(port, baud, timeout=1) as ser, open(log_path, "w") as log:
+        while time.time() < deadline:
+            line = ser.readline().decode(errors="replace")
+            if not line:
+                continue
+            log.write(line)
+            log.flush()
+            result = parse_result(line)
+            if result is not None:
+                break
+    return result
+
+
+def table(rows, base_name):
+    base = None
+    for name, _, _, r in rows:
+        if name == base_name and r is not None:
+            base = float(r.get("persec", 0))
+
+    print("| variant | opt | definitions | per sec | vs %s |" % base_name)
+    print("|---|---|---|---|---|")
+    for name, opt, defs, r in rows:
+        if r is None:
+            print("| %s | %s | %s | - | - |" % (name, opt, defs))
+            continue
+        persec = float(r.get("persec", 0))
+        delta = "-"
+        if base:
+            delta = "%+.2f%%" % ((persec - base) * 100.0 / base)
+        print("| %s | %s | %s | %.2f | %s |" % (name, opt, defs, persec, delta))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("manifest", help="variants.csv from the build directory")
+    ap.add_argument("--logs", default="bench_logs", help="directory for captured logs")
+    ap.add_argument("--port", help="UART the board reports on")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--timeout", type=int, default=120, help="seconds to wait per variant")
+    ap.add_argument("--flash", action="store_true", help="load each variant with picotool")
+    ap.add_argument("--offline", action="store_true", help="only read existing logs")
+    ap.add_argument("--base", default="base", help="variant to compare against")
+    args = ap.parse_args()
+
+    os.makedirs(args.logs, exist_ok=True)
+
+    rows = []
+    with open(args.manifest) as f:
+        for v in csv.DictReader(f):
+            name = v["variant"]
+            log_path = os.path.join(args.logs, name + ".log")
+            result = None
+            if args.offline:
+                if os.path.exists(log_path):
+                    result = read_log(log_path)
+            else:
+                if args.port is None:
+                    sys.exit("--port is required unless --offline")
+                if args.flash:
+                    flash(v["uf2"])
+                print("Running %s..." % name, file=sys.stderr)
+                result = capture(args.port, args.baud, args.timeout, log_path)
+            rows.append((name, v["optimisation"], v["definitions"], result))
+
+    table(rows, args.base)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,160 @@
+/*
+ * format_bench.cpp
+ *
+ * Host comparison of TextBuffer against newlib/glibc snprintf for the
+ * lines the firmware actually builds. Reports time per line and the
+ * peak stack each formatter needs, measured by running it on a painted
+ * stack of its own.
+ *
+ * Each row is one kind of line: ns per line for each formatter, then
+ * the peak stack bytes each used. The time of a line varies from run
+ * to run, so run it a few times and only read a difference that holds
+ * across runs. The stack figures do not vary.
+ *
+ *    g++ -O2 -I../src format_bench.cpp ../src/TextBuffer.cpp -o format_bench
+ *    ./format_bench
+ *
+ * On target the same comparison is read from the build: code size with
+ * arm-none-eabi-nm --size-sort PICalc2Core.elf | grep -i printf, and
+ * each Agent's stack headroom from TST_V.agents[].stackFree.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TextBuffer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <ucontext.h>
+
+#define BENCH_REPS		200000
+#define STACK_BYTES		(64 * 1024)
+#define STACK_PAINT		0xA5
+
+static char line[80];
+static volatile size_t sink;
+
+static uint32_t total = 1234567;
+static uint32_t sampleMs = 60012;
+static uint32_t rate = 2057195;	//x1000
+static const char *name = "Worker 3";
+
+/***
+ * Counter::report RESULT line
+ */
+static void resultPrintf(){
+	sink = snprintf(line, sizeof(line), "RESULT variant=%s ms=%lu total=%lu persec=%lu.%03lu\n\r",
+			"default", (unsigned long)sampleMs, (unsigned long)total,
+			(unsigned long)(rate / 1000), (unsigned long)(rate % 1000));
+}
+
+static void resultText(){
+	TextBuffer text(line, sizeof(line));
+	text.add("RESULT variant=").add("default")
+		.add(" ms=").addUnsigned(sampleMs)
+		.add(" total=").addUnsigned(total)
+		.add(" persec=").addFixed(rate, 3).add("\n\r");
+	sink = text.length();
+}
+
+/***
+ * MigrationMonitor::report table row
+ */
+static void rowPrintf(){
+	sink = snprintf(line, sizeof(line), "%-15s\t%lu\t%lu.%02lu\t\t%lu.%lu%%\n\r",
+			name, (unsigned long)total,
+			(unsigned long)(rate / 100), (unsigned long)(rate % 100),
+			(unsigned long)(sampleMs / 10), (unsigned long)(sampleMs % 10));
+}
+
+static void rowText(){
+	TextBuffer text(line, sizeof(line));
+	text.add(name, 15)
+		.add('\t').addUnsigned(total)
+		.add('\t').addFixed(rate, 2)
+		.add("\t\t").addFixed(sampleMs, 1).add("%\n\r");
+	sink = text.length();
+}
+
+/***
+ * TSTAgent hex dump, one byte
+ */
+static void hexPrintf(){
+	sink = snprintf(line, sizeof(line), "%02X ", (unsigned)(total & 0xFF));
+}
+
+static void hexText(){
+	TextBuffer text(line, sizeof(line));
+	text.addHex(total & 0xFF, 2).add(' ');
+	sink = text.length();
+}
+
+static ucontext_t mainContext;
+static ucontext_t benchContext;
+static uint8_t benchStack[STACK_BYTES];
+static void (*pBenchFn)();
+
+static void trampoline(){
+	pBenchFn();
+}
+
+/***
+ * Peak stack used by fn, including the trampoline frame
+ * @param fn
+ * @return bytes
+ */
+static size_t stackUse(void (*fn)()){
+	memset(benchStack, STACK_PAINT, sizeof(benchStack));
+	pBenchFn = fn;
+	getcontext(&benchContext);
+	benchContext.uc_stack.ss_sp = benchStack;
+	benchContext.uc_stack.ss_size = sizeof(benchStack);
+	benchContext.uc_link = &mainContext;
+	makecontext(&benchContext, trampoline, 0);
+	swapcontext(&mainContext, &benchContext);
+
+	//Stack grows down, find the deepest byte written
+	size_t untouched = 0;
+	while ((untouched < sizeof(benchStack)) && (benchStack[untouched] == STACK_PAINT)){
+		untouched++;
+	}
+	return sizeof(benchStack) - untouched;
+}
+
+/***
+ * Mean time per call
+ * @param fn
+ * @return ns
+ */
+static double timeNs(void (*fn)()){
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < BENCH_REPS; i++){
+		fn();
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / BENCH_REPS;
+}
+
+static void compare(const char *label, void (*printfFn)(), void (*textFn)()){
+	char check[sizeof(line)];
+	printfFn();
+	strcpy(check, line);
+	textFn();
+	if (strcmp(check, line) != 0){
+		printf("%s: output differs\n  printf: %s\n  text:   %s\n", label, check, line);
+	}
+
+	printf("%-8s\t%8.1f\t%8.1f\t%8zu\t%8zu\n", label,
+			timeNs(printfFn), timeNs(textFn),
+			stackUse(printfFn), stackUse(textFn));
+}
+
+int main(){
+	printf("Line\t\tprintf ns\tText ns\t\tprintf stack\tText stack\n");
+	compare("result", resultPrintf, resultText);
+	compare("row", rowPrintf, rowText);
+	compare("hex", hexPrintf, hexText);
+	return 0;
+}
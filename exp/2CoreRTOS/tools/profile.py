@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Symbolise profiler samples and print flat and per task profiles.
+
+Build with -DPROFILE=1 and capture the UART. Profiler streams the PC
+and task interrupted on each core as PROF lines, PROFILER_HZ times a
+second. This script maps each PC to the function that holds it using
+the symbol table of PICalc2Core.elf, so it needs no ARM toolchain and
+runs against a saved capture on any host:
+
+    profile.py capture.log build/src/PICalc2Core.elf
+    profile.py capture.log build/src/PICalc2Core.elf --top 40 --core 1
+
+Names are demangled with c++filt when it is on the path.
+
+testdata holds a short recorded capture, an elf with only a symbol
+table to match it, and the expected output. The capture covers both
+cores, a named and an unnamed task, an interrupt sample, PCs outside
+every function and a truncated line. After changing the script:
+
+    profile.py testdata/profile.log testdata/profile.elf | diff testdata/profile.expected -
+
+Jon Durrant - 2026
+"""
+
+import argparse
+import bisect
+import collections
+import re
+import shutil
+import struct
+import subprocess
+import sys
+
+TASK_RE = re.compile(r"PROF task=(\d+) name=(.*?)\s*$")
+SAMPLES_RE = re.compile(r"PROF (\d+) ([0-9A-Fa-f]+)")
+
+FLAG_HANDLER = 0x01     # PROFILER_FLAG_HANDLER
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+
+def read_samples(path):
+    """Task names and (core, pc, task, flags) from a capture"""
+    names = {}
+    samples = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = TASK_RE.search(line)
+            if m is not None:
+                names[int(m.group(1))] = m.group(2)
+                continue
+            m = SAMPLES_RE.search(line)
+            if m is not None:
+                core, data = int(m.group(1)), m.group(2)
+                for i in range(0, len(data) - 11, 12):
+                    samples.append((core,
+                                    int(data[i:i + 8], 16),
+                                    int(data[i + 8:i + 10], 16),
+                                    int(data[i + 10:i + 12], 16)))
+    return names, samples
+
+
+def read_functions(path):
+    """Sorted (start, size, name) of every function symbol in an ELF"""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        sys.exit("%s is not an ELF file" % path)
+    is64 = elf[4] == 2
+    end = "<" if elf[5] == 1 else ">"
+
+    if is64:
+        shoff, = struct.unpack_from(end + "Q", elf, 0x28)
+        shentsize, shnum = struct.unpack_from(end + "HH", elf, 0x3A)
+        sh_fmt, sym_fmt = end + "IIQQQQIIQQ", end + "IBBHQQ"
+    else:
+        shoff, = struct.unpack_from(end + "I", elf, 0x20)
+        shentsize, shnum = struct.unpack_from(end + "HH", elf, 0x2E)
+        sh_fmt, sym_fmt = end + "IIIIIIIIII", end + "IIIBBH"
+
+    sections = [struct.unpack_from(sh_fmt, elf, shoff + i * shentsize) for i in range(shnum)]
+    funcs = {}
+    for sh in sections:
+        if sh[1] != SHT_SYMTAB:
+            continue
+        offset, size, link, entsize = sh[4], sh[5], sh[6], sh[9]
+        strtab = sections[link]
+        str_off = strtab[4]
+        for i in range(size // entsize):
+            sym = struct.unpack_from(sym_fmt, elf, offset + i * entsize)
+            if is64:
+                name_off, info, _, _, value, sym_size = sym
+            else:
+                name_off, value, sym_size, info, _, _ = sym
+            if (info & 0xF) != STT_FUNC or value == 0:
+                continue
+            name_end = elf.index(b"\0", str_off + name_off)
+            name = elf[str_off + name_off:name_end].decode(errors="replace")
+            # Thumb functions have bit 0 set
+            funcs[value & ~1] = (sym_size, name)
+    return [(start, size, name) for start, (size, name) in sorted(funcs.items())]
+
+
+def demangle(names):
+    tool = shutil.which("c++filt") or shutil.which("arm-none-eabi-c++filt")
+    if tool is None or not names:
+        return dict((n, n) for n in names)
+    out = subprocess.run([tool], input="\n".join(names), capture_output=True,
+                         text=True).stdout.splitlines()
+    if len(out) != len(names):
+        return dict((n, n) for n in names)
+    return dict(zip(names, out))
+
+
+class Symboliser:
+    def __init__(self, functions):
+        self.starts = [f[0] for f in functions]
+        self.functions = functions
+
+    def lookup(self, pc):
+        pc &= ~1
+        i = bisect.bisect_right(self.starts, pc) - 1
+        if i >= 0:
+            start, size, name = self.functions[i]
+            # Hand written assembly often has no size, take the nearest
+            if pc < start + size or size == 0:
+                return name
+        return "0x%08x" % pc
+
+
+def table(title, counts, total, top):
+    print(title)
+    print("%8s %7s  %s" % ("samples", "%", "function"))
+    for name, n in counts.most_common(top):
+        print("%8d %6.2f%%  %s" % (n, 100.0 * n / total, name))
+    print()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("log", help="capture with the PROF lines")
+    ap.add_argument("elf", help="the elf the samples were taken from")
+    ap.add_argument("--top", type=int, default=25, help="functions per table")
+    ap.add_argument("--core", type=int, help="only samples from this core")
+    args = ap.parse_args()
+
+    names, samples = read_samples(args.log)
+    if args.core is not None:
+        samples = [s for s in samples if s[0] == args.core]
+    if not samples:
+        sys.exit("No PROF samples in %s, build with -DPROFILE=1" % args.log)
+
+    sym = Symboliser(read_functions(args.elf))
+    raw = [sym.lookup(pc) for _, pc, _, _ in samples]
+    pretty = demangle(sorted(set(raw)))
+
+    flat = collections.Counter()
+    by_task = collections.defaultdict(collections.Counter)
+    for (core, pc, task, flags), fn in zip(samples, raw):
+        fn = pretty[fn]
+        flat[fn] += 1
+        if flags & FLAG_HANDLER:
+            owner = "Interrupts"
+        else:
+            owner = names.get(task, "Task %d" % task)
+        by_task[owner][fn] += 1
+
+    total = len(samples)
+    per_core = collections.Counter(s[0] for s in samples)
+    print("%d samples, %s\n" % (total, ", ".join(
+        "core %d %d" % (c, n) for c, n in sorted(per_core.items()))))
+
+    table("Flat profile", flat, total, args.top)
+
+    owners = sorted(by_task.items(), key=lambda kv: -sum(kv[1].values()))
+    for owner, counts in owners:
+        n = sum(counts.values())
+        table("%s: %d samples, %.2f%%" % (owner, n, 100.0 * n / total), counts, n, args.top)
+
+
+if __name__ == "__main__":
+    main()
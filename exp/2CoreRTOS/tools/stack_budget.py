@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+Generate src/StackBudgets.h from a stack calibration build and run.
+
+Configure with -DPICALC_STACK_CALIBRATE=ON and build. GCC then writes a
+.ci call graph with the frame size of every function next to each
+object file. Flash the build, let it run to the end and capture the
+UART, which ends with one line per Agent:
+
+    STACK kind=Worker used=812 size=5000 agent=Worker 1
+
+For each kind of Agent in the current StackBudgets.h the budget is the
+deeper of
+  - static: the worst path through the call graph from Kind::run(),
+    plus Agent::vTask and the task context, and
+  - runtime: the most any Agent of that kind used, from stack painting,
+plus the margin, rounded up to the alignment.
+
+Static depth is a lower bound when the path has indirect or virtual
+calls or calls into code built without stack usage, it is marked
+partial and the runtime figure covers the rest.
+
+    stack_budget.py --build build --log calibrate.log
+    stack_budget.py --build build --log calibrate.log --write
+
+Jon Durrant - 2026
+"""
+
+import argparse
+import glob
+import math
+import os
+import re
+import sys
+
+NODE_RE = re.compile(r'node:\s*\{\s*title:\s*"([^"]+)"\s*label:\s*"([^"]*)"')
+EDGE_RE = re.compile(r'edge:\s*\{\s*sourcename:\s*"([^"]+)"\s*targetname:\s*"([^"]+)"')
+BYTES_RE = re.compile(r"(\d+) bytes \((static|dynamic|dynamic,bounded)\)")
+STACK_RE = re.compile(r"STACK\s+kind=(\S+)\s+used=(\d+)\s+size=(\d+)\s+agent=(.*)")
+BUDGET_RE = re.compile(r"constexpr configSTACK_DEPTH_TYPE (\w+)\s*=\s*(\d+);")
+
+INDIRECT = "__indirect_call"
+WORD = 4
+
+
+class CallGraph:
+    def __init__(self):
+        self.frames = {}    # title -> bytes, None if unknown
+        self.names = {}     # title -> demangled name
+        self.calls = {}     # title -> set of titles
+
+    def load(self, path):
+        with open(path, errors="replace") as f:
+            text = f.read()
+        for title, label in NODE_RE.findall(text):
+            lines = label.split("\\n")
+            self.names.setdefault(title, lines[0])
+            m = BYTES_RE.search(label)
+            if m is not None:
+                self.frames[title] = int(m.group(1))
+            else:
+                self.frames.setdefault(title, None)
+        for src, dst in EDGE_RE.findall(text):
+            self.calls.setdefault(src, set()).add(dst)
+
+    def find(self, name):
+        """Titles whose demangled name is exactly name()"""
+        pat = re.compile(r"(^|\s)" + re.escape(name) + r"\(\)")
+        return [t for t, n in self.names.items() if pat.search(n) and self.frames.get(t) is not None]
+
+    def depth(self, title, path=None):
+        """Worst stack in bytes from title, and whether it is complete"""
+        if path is None:
+            path = set()
+        if title == INDIRECT or title in path:
+            # Indirect call or recursion, cannot be bounded statically
+            return 0, False
+        frame = self.frames.get(title)
+        if frame is None:
+            return 0, False
+        path.add(title)
+        worst = 0
+        complete = True
+        for callee in self.calls.get(title, ()):
+            d, c = self.depth(callee, path)
+            worst = max(worst, d)
+            complete = complete and c
+        path.discard(title)
+        return frame + worst, complete
+
+
+def read_log(path):
+    """Most words used by any Agent of each kind"""
+    used = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = STACK_RE.search(line)
+            if m is None:
+                continue
+            kind, words = m.group(1), int(m.group(2))
+            used[kind] = max(used.get(kind, 0), words)
+    return used
+
+
+def read_budgets(path):
+    with open(path) as f:
+        return dict((k, int(v)) for k, v in BUDGET_RE.findall(f.read()))
+
+
+def write_budgets(path, budgets):
+    with open(path) as f:
+        text = f.read()
+    width = max(len(k) for k in budgets)
+    body = "//Generated by tools/stack_budget.py from a calibration run\n"
+    body += "\n".join("constexpr configSTACK_DEPTH_TYPE %s = %d;" % (k.ljust(width), v)
+                      for k, v in sorted(budgets.items()))
+    start = text.index("namespace StackBudgets {") + len("namespace StackBudgets {")
+    end = text.index("\n}", start)
+    with open(path, "w") as f:
+        f.write(text[:start] + "\n\n" + body + "\n" + text[end:])
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--build", required=True, help="calibration build directory")
+    ap.add_argument("--log", help="UART capture with the STACK lines")
+    ap.add_argument("--header", default=os.path.join(here, "..", "src", "StackBudgets.h"))
+    ap.add_argument("--margin", type=int, default=25, help="percent added to the need")
+    ap.add_argument("--context", type=int, default=64,
+                    help="words for the saved task context and interrupt frames")
+    ap.add_argument("--align", type=int, default=16, help="round budgets up to this many words")
+    ap.add_argument("--write", action="store_true", help="update the header")
+    args = ap.parse_args()
+
+    graph = CallGraph()
+    files = glob.glob(os.path.join(args.build, "**", "*.ci"), recursive=True)
+    if not files:
+        sys.exit("No .ci files under %s, configure with -DPICALC_STACK_CALIBRATE=ON" % args.build)
+    for path in files:
+        graph.load(path)
+
+    used = read_log(args.log) if args.log else {}
+    current = read_budgets(args.header)
+
+    entry = 0
+    for title in graph.find("Agent::vTask"):
+        entry = max(entry, graph.depth(title)[0])
+
+    budgets = {}
+    print("| kind | static words | runtime words | budget | was |")
+    print("|---|---|---|---|---|")
+    for kind, was in sorted(current.items()):
+        static_bytes = 0
+        complete = False
+        for title in graph.find(kind + "::run"):
+            d, c = graph.depth(title)
+            if d >= static_bytes:
+                static_bytes, complete = d, c
+        static_words = int(math.ceil((static_bytes + entry) / WORD)) + args.context
+        runtime_words = used.get(kind)
+
+        need = static_words
+        if runtime_words is not None:
+            need = max(need, runtime_words)
+        budget = int(math.ceil(need * (100 + args.margin) / 100.0))
+        budget = int(math.ceil(budget / float(args.align))) * args.align
+
+        if runtime_words is None and not complete:
+            # Nothing reliable to go on, keep what we have
+            budget = was
+        budgets[kind] = budget
+
+        print("| %s | %d%s | %s | %d | %d |" % (
+            kind, static_words, "" if complete else " partial",
+            "-" if runtime_words is None else runtime_words, budget, was))
+
+    print("\nTotal %d words, was %d" % (sum(budgets.values()), sum(current.values())))
+    if args.write:
+        write_budgets(args.header, budgets)
+        print("Wrote %s" % args.header)
+
+
+if __name__ == "__main__":
+    main()
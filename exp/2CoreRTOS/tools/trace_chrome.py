@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""
+Convert a scheduler trace dump to Chrome trace JSON.
+
+Build with -DTRACE_DUMP=1 and capture the UART to the end of the run.
+TraceRecorder prints the event ring of each core as TRACE lines. This
+script turns them into a trace that chrome://tracing or
+ui.perfetto.dev opens, with two views of the same events:
+
+  Cores   one row per core showing which task ran and when, with a
+          second row per core for interrupt handlers
+  Tasks   one row per task showing which core it ran on
+
+Notifications and queue operations appear as instant events on the
+core that made them.
+
+    trace_chrome.py capture.log -o trace.json
+
+Jon Durrant - 2026
+"""
+
+import argparse
+import json
+import re
+import sys
+
+BEGIN_RE = re.compile(r"TRACE begin cores=(\d+) events=(\d+) cost_ns=(\d+)")
+TASK_RE = re.compile(r"TRACE task=(\d+) name=(.*?)\s*$")
+CORE_RE = re.compile(r"TRACE core=(\d+) first=(\d+) count=(\d+)")
+EVENTS_RE = re.compile(r"TRACE E (\d+) ([0-9A-Fa-f]+)")
+
+# Event types from traceHooks.h
+EV_MARK = 0
+EV_SWITCH_IN = 1
+EV_SWITCH_OUT = 2
+EV_NOTIFY = 3
+EV_NOTIFY_WAIT = 4
+EV_QUEUE_SEND = 5
+EV_QUEUE_RECEIVE = 6
+EV_QUEUE_BLOCK_SEND = 7
+EV_QUEUE_BLOCK_RECEIVE = 8
+EV_ISR_ENTER = 9
+EV_ISR_EXIT = 10
+
+PID_CORES = 0
+PID_TASKS = 1
+TID_ISR = 100   # ISR row of core c is TID_ISR + c
+
+
+def read_dump(path):
+    """Task names and raw events per core from the last dump in the log"""
+    names = {}
+    events = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            if BEGIN_RE.search(line):
+                names, events = {}, {}
+                continue
+            m = TASK_RE.search(line)
+            if m is not None:
+                names[int(m.group(1))] = m.group(2)
+                continue
+            m = CORE_RE.search(line)
+            if m is not None:
+                events[int(m.group(1))] = []
+                continue
+            m = EVENTS_RE.search(line)
+            if m is not None:
+                core, data = int(m.group(1)), m.group(2)
+                for i in range(0, len(data) - 15, 16):
+                    events.setdefault(core, []).append((
+                        int(data[i:i + 8], 16),
+                        int(data[i + 8:i + 10], 16),
+                        int(data[i + 10:i + 12], 16),
+                        int(data[i + 12:i + 16], 16)))
+    return names, events
+
+
+def unwrap(events):
+    """Replace 32 bit us timestamps with us from the first event.
+
+    Both cores read the same timer, so every time is taken relative to one
+    reference. The rings cover far less than the 71 minute wrap.
+    """
+    ref = None
+    for core in events:
+        if events[core]:
+            ref = events[core][-1][0]
+            break
+    if ref is None:
+        return events
+
+    def signed(t):
+        d = (t - ref) & 0xFFFFFFFF
+        return d - 0x100000000 if d & 0x80000000 else d
+
+    out = {}
+    for core, evs in events.items():
+        out[core] = [(signed(t), typ, task, arg) for t, typ, task, arg in evs]
+    start = min(e[0] for evs in out.values() for e in evs if evs)
+    return dict((c, [(t - start, typ, task, arg) for t, typ, task, arg in evs])
+                for c, evs in out.items())
+
+
+def convert(names, events):
+    trace = []
+
+    def name(task):
+        return names.get(task, "Task %d" % task)
+
+    def slice(pid, tid, label, start, end, args=None):
+        if end > start:
+            trace.append({"ph": "X", "pid": pid, "tid": tid, "name": label,
+                          "ts": start, "dur": end - start, "args": args or {}})
+
+    def instant(core, label, t, args):
+        trace.append({"ph": "i", "s": "t", "pid": PID_CORES, "tid": core,
+                      "name": label, "ts": t, "args": args})
+
+    trace.append({"ph": "M", "pid": PID_CORES, "name": "process_name", "args": {"name": "Cores"}})
+    trace.append({"ph": "M", "pid": PID_TASKS, "name": "process_name", "args": {"name": "Tasks"}})
+
+    tasks = set()
+    for core, evs in sorted(events.items()):
+        trace.append({"ph": "M", "pid": PID_CORES, "tid": core, "name": "thread_name",
+                      "args": {"name": "Core %d" % core}})
+        trace.append({"ph": "M", "pid": PID_CORES, "tid": TID_ISR + core, "name": "thread_name",
+                      "args": {"name": "Core %d ISR" % core}})
+
+        running = None      # (task, since)
+        isr = []            # stack of (exception, since)
+        for t, typ, task, arg in evs:
+            if typ in (EV_SWITCH_IN, EV_SWITCH_OUT):
+                if running is not None:
+                    slice(PID_CORES, core, name(running[0]), running[1], t, {"task": running[0]})
+                    slice(PID_TASKS, running[0], "Core %d" % core, running[1], t)
+                    tasks.add(running[0])
+                running = (arg, t) if typ == EV_SWITCH_IN else None
+            elif typ == EV_ISR_ENTER:
+                isr.append((arg, t))
+            elif typ == EV_ISR_EXIT:
+                if isr:
+                    exc, since = isr.pop()
+                    slice(PID_CORES, TID_ISR + core, "IRQ %d" % (exc - 16) if exc >= 16
+                          else "Exception %d" % exc, since, t)
+            elif typ == EV_NOTIFY:
+                instant(core, "notify %s" % name(arg), t, {"from": name(task), "to": name(arg)})
+            elif typ == EV_NOTIFY_WAIT:
+                instant(core, "wait", t, {"task": name(task), "index": arg})
+            elif typ in (EV_QUEUE_SEND, EV_QUEUE_RECEIVE, EV_QUEUE_BLOCK_SEND, EV_QUEUE_BLOCK_RECEIVE):
+                label = {EV_QUEUE_SEND: "send", EV_QUEUE_RECEIVE: "receive",
+                         EV_QUEUE_BLOCK_SEND: "block on send",
+                         EV_QUEUE_BLOCK_RECEIVE: "block on receive"}[typ]
+                instant(core, label, t, {"task": name(task), "queue": "0x%04x" % arg})
+        if running is not None and evs:
+            slice(PID_CORES, core, name(running[0]), running[1], evs[-1][0], {"task": running[0]})
+
+    for task in sorted(tasks):
+        trace.append({"ph": "M", "pid": PID_TASKS, "tid": task, "name": "thread_name",
+                      "args": {"name": name(task)}})
+        trace.append({"ph": "M", "pid": PID_TASKS, "tid": task, "name": "thread_sort_index",
+                      "args": {"sort_index": task}})
+    return trace
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("log", help="UART capture with the TRACE lines")
+    ap.add_argument("-o", "--out", default="trace.json")
+    args = ap.parse_args()
+
+    names, events = read_dump(args.log)
+    if not any(events.values()):
+        sys.exit("No TRACE events in %s, build with -DTRACE_DUMP=1" % args.log)
+    events = unwrap(events)
+
+    with open(args.out, "w") as f:
+        json.dump({"traceEvents": convert(names, events), "displayTimeUnit": "ns"}, f)
+
+    for core, evs in sorted(events.items()):
+        span = (evs[-1][0] - evs[0][0]) if evs else 0
+        print("Core %d: %d events over %d us" % (core, len(evs), span))
+    print("Wrote %s" % args.out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,21 @@
+# Build variants for the PICalc2Core benchmark matrix.
+# Enabled with -DPICALC_VARIANTS=ON
+#
+# Each entry is name|compiler flags|definitions, definitions are comma
+# separated and override the defaults in FreeRTOSConfig.h.
+# Vary one setting at a time from base so differences can be attributed.
+
+set(PICALC_VARIANT_LIST
+	"base|-O3|"
+	"O2|-O2|"
+	"Os|-Os|"
+	"tick100|-O3|configTICK_RATE_HZ=100"
+	"tick250|-O3|configTICK_RATE_HZ=250"
+	"noslice|-O3|configUSE_TIME_SLICING=0"
+	"singleprio|-O3|configRUN_MULTIPLE_PRIORITIES=0"
+	"notickless|-O3|configUSE_TICKLESS_IDLE=0"
+	"nostackcheck|-O3|configCHECK_FOR_STACK_OVERFLOW=0"
+	"stackcheck2|-O3|configCHECK_FOR_STACK_OVERFLOW=2"
+	"notrace|-O3|TRACE_RECORDER=0"
+	"noscope|-O3|SCOPE_TIMERS=0"
+	)
@@ -43,7 +43,7 @@
 /* Scheduler Related */
 #define configUSE_PREEMPTION                    1
 #define configUSE_TICKLESS_IDLE                 1   
-#define configUSE_IDLE_HOOK                     0
+#define configUSE_IDLE_HOOK                     1
 #define configUSE_TICK_HOOK                     0
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES                    32
@@ -108,7 +108,7 @@
 #define configRUN_MULTIPLE_PRIORITIES           1
 #define configUSE_CORE_AFFINITY                 1
 #define configNUM_CORES 					    configNUMBER_OF_CORES  //SDK still relies on this
-#define configUSE_PASSIVE_IDLE_HOOK			    0
+#define configUSE_PASSIVE_IDLE_HOOK			    1
 
 /* RP2040 specific */
 #define configSUPPORT_PICO_SYNC_INTEROP         1
@@ -138,6 +138,7 @@ to exclude the API function. */
 #define INCLUDE_xQueueGetMutexHolder            1
 
 /* A header file that defines trace macro can be included here. */
+#include "traceHooks.h"
 
 
 #ifdef __cplusplus
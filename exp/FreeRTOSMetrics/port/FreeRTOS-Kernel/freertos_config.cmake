@@ -5,6 +5,7 @@ add_library(freertos_config STATIC)
 target_sources(freertos_config PUBLIC   
         ${CMAKE_CURRENT_LIST_DIR}/IdleMemory.c
         ${CMAKE_CURRENT_LIST_DIR}/cppMemory.cpp
+        ${CMAKE_CURRENT_LIST_DIR}/traceHooks.c
     )
 target_include_directories(freertos_config PUBLIC
 	${CMAKE_CURRENT_LIST_DIR}
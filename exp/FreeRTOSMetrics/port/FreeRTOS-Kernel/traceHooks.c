@@ -0,0 +1,89 @@
+/*
+ * traceHooks.c
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "FreeRTOS.h"
+#include "traceHooks.h"
+#include "hardware/timer.h"
+#include "hardware/sync.h"
+
+volatile uint32_t ulTraceSwitches[ configNUMBER_OF_CORES ] = { 0 };
+
+/* Idle accounting per core, only written by its own core. The sequence
+ * is odd while a write is in progress so the other core can read a
+ * consistent set. */
+static volatile uint32_t ulIdleSeq[ configNUMBER_OF_CORES ] = { 0 };
+static volatile uint32_t ulIdleUs[ configNUMBER_OF_CORES ] = { 0 };
+static volatile uint32_t ulIdleSinceUs[ configNUMBER_OF_CORES ] = { 0 };
+static volatile uint8_t ucInIdle[ configNUMBER_OF_CORES ] = { 0 };
+
+void vTraceTaskSwitchedIn( void ){
+	uint32_t ulCore = portGET_CORE_ID();
+	ulTraceSwitches[ ulCore ]++;
+
+	if( ucInIdle[ ulCore ] ){
+		ulIdleSeq[ ulCore ]++;
+		__dmb();
+		ulIdleUs[ ulCore ] += time_us_32() - ulIdleSinceUs[ ulCore ];
+		ucInIdle[ ulCore ] = 0;
+		__dmb();
+		ulIdleSeq[ ulCore ]++;
+	}
+}
+
+/***
+ * Open an idle stint on this core if one is not already open
+ */
+static void prvIdleEnter( void ){
+	uint32_t ulCore = portGET_CORE_ID();
+	if( ucInIdle[ ulCore ] ){
+		return;
+	}
+
+	/* Masked so a switch cannot land between the stamp and the flag */
+	uint32_t ulIrq = save_and_disable_interrupts();
+	ulIdleSeq[ ulCore ]++;
+	__dmb();
+	ulIdleSinceUs[ ulCore ] = time_us_32();
+	ucInIdle[ ulCore ] = 1;
+	__dmb();
+	ulIdleSeq[ ulCore ]++;
+	restore_interrupts( ulIrq );
+}
+
+void vApplicationIdleHook( void ){
+	prvIdleEnter();
+}
+
+void vApplicationPassiveIdleHook( void ){
+	prvIdleEnter();
+}
+
+uint32_t ulTraceGetIdleUs( uint32_t ulCore ){
+	uint32_t ulSeq;
+	uint32_t ulUs;
+	if( ulCore >= configNUMBER_OF_CORES ){
+		return 0;
+	}
+	do {
+		ulSeq = ulIdleSeq[ ulCore ];
+		__dmb();
+		ulUs = ulIdleUs[ ulCore ];
+		if( ucInIdle[ ulCore ] ){
+			ulUs += time_us_32() - ulIdleSinceUs[ ulCore ];
+		}
+		__dmb();
+	} while( ( ulSeq & 1 ) || ( ulSeq != ulIdleSeq[ ulCore ] ) );
+	return ulUs;
+}
+
+uint32_t ulTraceGetSwitchCount( void ){
+	uint32_t total = 0;
+	for( int i = 0; i < configNUMBER_OF_CORES; i++ ){
+		total += ulTraceSwitches[ i ];
+	}
+	return total;
+}
@@ -0,0 +1,58 @@
+/*
+ * traceHooks.h
+ *
+ * FreeRTOS trace macros used to gather metrics. Included from
+ * FreeRTOSConfig.h.
+ *
+ * Idle time per core: the idle hooks open an idle stint the first time
+ * they run after the idle task is switched in, the next switch in on
+ * that core closes it. A busy core only pays for one flag test at each
+ * switch.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef TRACEHOOKS_H_
+#define TRACEHOOKS_H_
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Context switches per core, each slot is only written by its own core */
+extern volatile uint32_t ulTraceSwitches[ configNUMBER_OF_CORES ];
+
+/***
+ * Total context switches on all cores since boot
+ * @return
+ */
+uint32_t ulTraceGetSwitchCount( void );
+
+/***
+ * Called from the scheduler as a task is switched in on this core
+ */
+void vTraceTaskSwitchedIn( void );
+
+/***
+ * Idle time of a core, including a stint still open. 32 bit so take
+ * differences over windows shorter than 71 minutes.
+ * @param ulCore
+ * @return us since boot
+ */
+uint32_t ulTraceGetIdleUs( uint32_t ulCore );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#define traceTASK_SWITCHED_IN()		vTraceTaskSwitchedIn()
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TRACEHOOKS_H_ */
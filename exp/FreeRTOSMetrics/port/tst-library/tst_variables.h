@@ -33,6 +33,17 @@ typedef struct __attribute__((packed)) {
     uint32_t heap_min_ever;
     uint32_t task_count;
     uint32_t led_status; // 0=off, 1=on
+    uint32_t ctx_switches; // per sec, both cores
+    uint16_t load_100ms[2]; // per core, per mille busy
+    uint16_t load_1s[2];
+    uint16_t load_10s[2];
+    uint32_t heap_largest; // largest free block, bytes
+    uint32_t heap_smallest; // smallest free block, bytes
+    uint32_t heap_blocks; // free blocks
+    uint32_t heap_allocs; // successful pvPortMalloc since boot
+    uint32_t heap_frees; // successful vPortFree since boot
+    uint16_t heap_frag; // per mille of free space outside the largest block
+    int16_t heap_frag_trend; // change in heap_frag over the trend window
 } TST_Variables;
 
 /*TSTVARIABLESEND*/
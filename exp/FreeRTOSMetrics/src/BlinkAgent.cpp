@@ -8,6 +8,9 @@
 #include "BlinkAgent.h"
 
 #include "stdio.h"
+extern "C"{
+#include "tst_variables.h"
+}
 
 
 //Blink Delay
@@ -31,29 +34,31 @@ BlinkAgent::~BlinkAgent() {
 
 
  /***
-  * Main Run Task for agent
+  * Start blinking
+  * @param name - Give the timer a name (<20 characters)
+  * @return
+  */
+bool BlinkAgent::start(const char *name){
+	return TimerAgent::start(name, DELAY);
+}
+
+ /***
+  * Set up the GPIO
   */
- void BlinkAgent::run(){
+void BlinkAgent::init(){
 
-	printf("Blink Started\n");
+	fputs("Blink Started\n", stdout);
 
 	gpio_init(xLedPad);
 
 	gpio_set_dir(xLedPad, GPIO_OUT);
+}
 
-	while (true) { // Loop forever
-		gpio_put(xLedPad, 1);
-		vTaskDelay(DELAY);
-		gpio_put(xLedPad, 0);
-		vTaskDelay(DELAY);
-	}
-
- }
-
-/***
- * Get the static depth required in words
- * @return - words
- */
-configSTACK_DEPTH_TYPE BlinkAgent::getMaxStackSize(){
-	return 150;
+ /***
+  * Toggle the LED
+  */
+void BlinkAgent::tick(){
+	xOn = !xOn;
+	gpio_put(xLedPad, xOn);
+	TST_V.led_status = xOn;
 }
@@ -1,7 +1,7 @@
 /*
  * BlinkAgent.h
  *
- * Active agent to run as task and blink and LED on the given GPIO pad
+ * Timer agent to blink and LED on the given GPIO pad
  *
  *  Created on: 15 Aug 2022
  *      Author: jondurrant
@@ -12,12 +12,11 @@
 
 #include "pico/stdlib.h"
 #include "FreeRTOS.h"
-#include "task.h"
 
-#include "Agent.h"
+#include "TimerAgent.h"
 
 
-class BlinkAgent: public Agent {
+class BlinkAgent: public TimerAgent {
 public:
 	/***
 	 * Constructor
@@ -30,24 +29,32 @@ public:
 	 */
 	virtual ~BlinkAgent();
 
+	/***
+	 * Start blinking
+	 * @param name - Give the timer a name (<20 characters)
+	 * @return
+	 */
+	virtual bool start(const char *name);
+	using TimerAgent::start;
+
 
 protected:
 
 	/***
-	 * Run loop for the agent.
+	 * Set up the GPIO
 	 */
-	virtual void run();
-
+	virtual void init();
 
 	/***
-	 * Get the static depth required in words
-	 * @return - words
+	 * Toggle the LED
 	 */
-	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+	virtual void tick();
 
 	//GPIO PAD for LED
 	uint8_t xLedPad = 0;
 
+	bool xOn = false;
+
 };
 
 
@@ -7,6 +7,8 @@
 
 #include "TSTAgent.h"
 #include "pico/stdlib.h"
+#include "TextBuffer.h"
+#include <cstdio>
 
 #define DEBUG_LINE 15
 
@@ -44,8 +46,9 @@ void TSTAgent::run(){
 			//debugPrintBuffer( "Read",   rxData,  read);
 			uint8_t err = tstRx(TST_Device.name, TST_Interface.interface, rxData, read);
 			if (err != TST_OK){
-				char errTxt[10];
-				sprintf(errTxt,"Error: %u", err);
+				char errTxt[12];
+				TextBuffer text(errTxt, sizeof(errTxt));
+				text.add("Error: ").addUnsigned(err);
 				tstMonitorSend(TST_Device.name, TST_Interface.interface, errTxt);
 			}
 		}
@@ -115,40 +118,43 @@ void TSTAgent::debugPrintBuffer(const char *title, const void * pBuffer, size_t
 	size_t count =0;
 	size_t lineEnd=0;
 	const uint8_t *pBuf = (uint8_t *)pBuffer;
+	char line[DEBUG_LINE * 4 + 2];
+	TextBuffer text(line, sizeof(line));
 
-	printf("DEBUG: %s of size %d\n", title, bytes);
+	fputs("DEBUG: ", stdout);
+	fputs(title, stdout);
+	text.add(" of size ").addUnsigned(bytes).add('\n');
+	fputs(text.c_str(), stdout);
 
 	while (count < bytes){
 		lineEnd = count + DEBUG_LINE;
 		if (lineEnd > bytes){
 			lineEnd = bytes;
 		}
+		text.clear();
 
-		//Print HEX DUMP
+		//HEX DUMP
 		for (size_t i=count; i < lineEnd; i++){
-			if (pBuf[i] <= 0x0F){
-				printf("0%X ", pBuf[i]);
-			} else {
-				printf("%X ", pBuf[i]);
-			}
+			text.addHex(pBuf[i], 2).add(' ');
 		}
 
 		//Pad for short lines
 		size_t pad = (DEBUG_LINE - (lineEnd - count)) * 3;
 		for (size_t i=0; i < pad; i++){
-			printf(" ");
+			text.add(' ');
 		}
 
-		//Print Plain Text
+		//Plain Text
 		for (size_t i=count; i < lineEnd; i++){
 			if ((pBuf[i] >= 0x20) && (pBuf[i] <= 0x7e)){
-				printf("%c", pBuf[i]);
+				text.add((char)pBuf[i]);
 			} else {
-				printf(".");
+				text.add('.');
 			}
 		}
 
-		printf("\n");
+		text.add('\n');
+		fputs(text.c_str(), stdout);
 
 		count = lineEnd;
 
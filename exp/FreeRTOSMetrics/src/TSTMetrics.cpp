@@ -6,6 +6,8 @@
  */
 
 #include "TSTMetrics.h"
+#include "traceHooks.h"
+#include "TextBuffer.h"
 
 TSTMetrics::TSTMetrics() {
 	// TODO Auto-generated constructor stub
@@ -13,41 +15,180 @@ TSTMetrics::TSTMetrics() {
 }
 
 TSTMetrics::~TSTMetrics() {
-	// TODO Auto-generated destructor stub
+	stop();
+	if (xReportTask != NULL){
+		vTaskDelete(xReportTask);
+		xReportTask = NULL;
+	}
 }
 
-void TSTMetrics::run(){
-	for (;;){
-		vTaskList(stats_buffer);
-		char msg[TSTMAXSIZE];
-
-		for (int i=0; i < 20; i++){
+bool TSTMetrics::start(const char *name){
+	return TimerAgent::start(name, TSTMETRICS_PERIOD_MS);
+}
 
-			// Update TST_V with system/monitoring variables
-			TST_V.heap_free = xPortGetFreeHeapSize();
-			TST_V.heap_min_ever = xPortGetMinimumEverFreeHeapSize();
-			TST_V.task_count = uxTaskGetNumberOfTasks();
+void TSTMetrics::init(){
+	xReportTask = xTaskCreateStatic(
+		TSTMetrics::vReport,
+		"Metrics Report",
+		TSTMETRICS_REPORT_STACK,
+		( void * ) this,
+		TSTMETRICS_REPORT_PRIORITY,
+		xReportStack,
+		&xReportTCB
+	);
+}
 
-			vTaskDelay(pdMS_TO_TICKS(100));
+void TSTMetrics::tick(){
+	// Update TST_V with system/monitoring variables
+	TST_V.heap_free = xPortGetFreeHeapSize();
+	TST_V.heap_min_ever = xPortGetMinimumEverFreeHeapSize();
+	TST_V.task_count = uxTaskGetNumberOfTasks();
+	updateLoad();
+
+	xTicks++;
+	if (xTicks >= TSTMETRICS_REPORT_TICKS){
+		uint32_t switches = ulTraceGetSwitchCount();
+		TST_V.ctx_switches = ((switches - xLastSwitches) * 1000) /
+				(TSTMETRICS_PERIOD_MS * TSTMETRICS_REPORT_TICKS);
+		xLastSwitches = switches;
+		xTicks = 0;
+		if (xReportTask != NULL){
+			xTaskNotifyGive(xReportTask);
 		}
+	}
+}
 
-		snprintf(msg, sizeof(msg), "Task List:\n%s", stats_buffer);
-		tstMonitorSend(TST_Device.name, TST_Interface.interface, msg);
+void TSTMetrics::vReport( void * pvParameters ){
+	TSTMetrics *metrics = (TSTMetrics *) pvParameters;
+	for (;;){
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		metrics->updateHeap();
+		metrics->updateFragTrend();
+		metrics->report();
+	}
+}
 
-		snprintf(msg, sizeof(msg), "Heap free: %u bytes", TST_V.heap_free);
-		tstMonitorSend(TST_Device.name, TST_Interface.interface, msg);
+void TSTMetrics::report(){
+	char msg[TSTMAXSIZE];
+	TextBuffer text(msg, sizeof(msg));
+
+	//One line per task rather than a vTaskList buffer
+	UBaseType_t n = uxTaskGetSystemState(xTaskStatus, TSTMETRICS_MAX_TASKS, NULL);
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, "Task List:");
+	for (UBaseType_t i = 0; i < n; i++){
+		text.clear();
+		text.add(xTaskStatus[i].pcTaskName)
+			.add('\t').addUnsigned(xTaskStatus[i].eCurrentState)
+			.add('\t').addUnsigned(xTaskStatus[i].uxCurrentPriority)
+			.add('\t').addUnsigned(xTaskStatus[i].usStackHighWaterMark);
+		tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+	}
 
-		snprintf(msg, sizeof(msg), "Heap min ever: %u bytes", TST_V.heap_min_ever);
-		tstMonitorSend(TST_Device.name, TST_Interface.interface, msg);
+	text.clear();
+	text.add("Heap free: ").addUnsigned(TST_V.heap_free).add(" bytes");
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+
+	text.clear();
+	text.add("Heap min ever: ").addUnsigned(TST_V.heap_min_ever).add(" bytes");
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+
+	text.clear();
+	text.add("Heap blocks: ").addUnsigned(TST_V.heap_blocks)
+		.add(" largest ").addUnsigned(TST_V.heap_largest)
+		.add(" smallest ").addUnsigned(TST_V.heap_smallest).add(" bytes");
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+
+	text.clear();
+	text.add("Heap frag: ").addFixed(TST_V.heap_frag, 1)
+		.add("% trend ").addSigned(TST_V.heap_frag_trend)
+		.add(" allocs ").addUnsigned(TST_V.heap_allocs)
+		.add(" frees ").addUnsigned(TST_V.heap_frees);
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+
+	text.clear();
+	text.add("Task count: ").addUnsigned(TST_V.task_count);
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+
+	text.clear();
+	text.add("Context switches: ").addUnsigned(TST_V.ctx_switches).add(" per sec");
+	tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+
+	for (uint8_t c = 0; c < configNUMBER_OF_CORES; c++){
+		text.clear();
+		text.add("Core ").addUnsigned(c)
+			.add(" load: ").addFixed(TST_V.load_100ms[c], 1)
+			.add("% ").addFixed(TST_V.load_1s[c], 1)
+			.add("% ").addFixed(TST_V.load_10s[c], 1).add('%');
+		tstMonitorSend(TST_Device.name, TST_Interface.interface, text.c_str());
+	}
+}
 
-		snprintf(msg, sizeof(msg), "Task count: %u", TST_V.task_count);
-		tstMonitorSend(TST_Device.name, TST_Interface.interface, msg);
+void TSTMetrics::updateLoad(){
+	uint32_t i = xLoadUpdates % TSTMETRICS_LOAD_HISTORY;
+	xLoadUs[i] = time_us_32();
+	for (uint8_t c = 0; c < configNUMBER_OF_CORES; c++){
+		xIdleUs[i][c] = ulTraceGetIdleUs(c);
+	}
 
+	for (uint8_t c = 0; c < configNUMBER_OF_CORES; c++){
+		TST_V.load_100ms[c] = load(c, TSTMETRICS_LOAD_SHORT);
+		TST_V.load_1s[c] = load(c, TSTMETRICS_LOAD_MID);
+		TST_V.load_10s[c] = load(c, TSTMETRICS_LOAD_LONG);
+	}
+	xLoadUpdates++;
+}
 
+uint16_t TSTMetrics::load(uint8_t core, uint32_t updates){
+	if (updates > xLoadUpdates){
+		updates = xLoadUpdates;
+	}
+	if (updates == 0){
+		return 0;
 	}
+	uint32_t now = xLoadUpdates % TSTMETRICS_LOAD_HISTORY;
+	uint32_t then = (xLoadUpdates - updates) % TSTMETRICS_LOAD_HISTORY;
 
+	uint32_t periodUs = xLoadUs[now] - xLoadUs[then];
+	uint32_t idleUs = xIdleUs[now][core] - xIdleUs[then][core];
+	if ((periodUs == 0) || (idleUs >= periodUs)){
+		return 0;
+	}
+	return (uint16_t)(((uint64_t)(periodUs - idleUs) * 1000) / periodUs);
 }
 
-configSTACK_DEPTH_TYPE TSTMetrics::getMaxStackSize(){
-	return 1024;
+void TSTMetrics::updateHeap(){
+	HeapStats_t stats;
+
+	//Walks the free list with the scheduler suspended, so kept off tick
+	vPortGetHeapStats(&stats);
+	TST_V.heap_free = stats.xAvailableHeapSpaceInBytes;
+	TST_V.heap_min_ever = stats.xMinimumEverFreeBytesRemaining;
+	TST_V.heap_largest = stats.xSizeOfLargestFreeBlockInBytes;
+	TST_V.heap_smallest = stats.xSizeOfSmallestFreeBlockInBytes;
+	TST_V.heap_blocks = stats.xNumberOfFreeBlocks;
+	TST_V.heap_allocs = stats.xNumberOfSuccessfulAllocations;
+	TST_V.heap_frees = stats.xNumberOfSuccessfulFrees;
+
+	//Share of free space that cannot be handed out in one allocation
+	if (stats.xAvailableHeapSpaceInBytes == 0){
+		TST_V.heap_frag = 0;
+	} else {
+		TST_V.heap_frag = (uint16_t)(1000 -
+				((uint64_t)stats.xSizeOfLargestFreeBlockInBytes * 1000) /
+				stats.xAvailableHeapSpaceInBytes);
+	}
+}
+
+void TSTMetrics::updateFragTrend(){
+	uint32_t i = xFragReports % TSTMETRICS_FRAG_TREND;
+	uint32_t oldest = (xFragReports >= TSTMETRICS_FRAG_TREND) ? i : 0;
+
+	//Compare with the oldest entry before it is overwritten
+	if (xFragReports == 0){
+		TST_V.heap_frag_trend = 0;
+	} else {
+		TST_V.heap_frag_trend = (int16_t)TST_V.heap_frag - (int16_t)xFrag[oldest];
+	}
+	xFrag[i] = TST_V.heap_frag;
+	xFragReports++;
 }
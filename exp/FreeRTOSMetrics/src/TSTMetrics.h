@@ -1,6 +1,12 @@
 /*
  * TSTMetrics.h
  *
+ * Timer agent that publishes FreeRTOS metrics to TST
+ *
+ * tick only updates cheap fields. Every TSTMETRICS_REPORT_TICKS it wakes
+ * a low priority report task to walk the heap and task list and send the
+ * monitor lines, so nothing slow runs on the timer service task.
+ *
  *  Created on: 8 Jul 2025
  *      Author: jondurrant
  */
@@ -8,33 +14,108 @@
 #ifndef EXP_FREERTOSMETRICS_SRC_TSTMETRICS_H_
 #define EXP_FREERTOSMETRICS_SRC_TSTMETRICS_H_
 
-#include "Agent.h"
-#include "pico/stdlib.h"
+#include "TimerAgent.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
 extern "C"{
 #include "tst_variables.h"
 }
 
-class TSTMetrics : public Agent{
+//Period between TST_V updates
+#define TSTMETRICS_PERIOD_MS	100
+//Number of updates between monitor reports
+#define TSTMETRICS_REPORT_TICKS	20
+#define TSTMETRICS_MAX_TASKS	12
+//Load windows in updates, 100 ms, 1 s and 10 s at the default period
+#define TSTMETRICS_LOAD_SHORT	1
+#define TSTMETRICS_LOAD_MID		10
+#define TSTMETRICS_LOAD_LONG	100
+#define TSTMETRICS_LOAD_HISTORY	(TSTMETRICS_LOAD_LONG + 1)
+//Fragmentation trend window in reports, 60 s at the defaults
+#define TSTMETRICS_FRAG_TREND	30
+//Report task, the priority the metrics task had before it was a timer
+#define TSTMETRICS_REPORT_PRIORITY	( tskIDLE_PRIORITY + 1UL )
+#define TSTMETRICS_REPORT_STACK		512
+
+class TSTMetrics : public TimerAgent{
 public:
 	TSTMetrics();
 	virtual ~TSTMetrics();
 
+	/***
+	 * Start publishing
+	 * @param name - Give the timer a name (<20 characters)
+	 * @return
+	 */
+	virtual bool start(const char *name);
+	using TimerAgent::start;
+
 protected:
 	/***
-	 * Task main run loop
+	 * Create the report task
 	 */
-	virtual void run();
+	virtual void init();
 
 	/***
-	 * Get the static depth required in words
-	 * @return - words
+	 * Update TST_V and periodically wake the report task
 	 */
-	virtual configSTACK_DEPTH_TYPE getMaxStackSize();
+	virtual void tick();
 
 private:
-	char stats_buffer[1024];
+	/***
+	 * Report task, waits for tick then reads the heap and reports
+	 * @param pvParameters - TSTMetrics
+	 */
+	static void vReport( void * pvParameters );
+
+	/***
+	 * Send task list, heap and task count to the monitor
+	 */
+	void report();
+
+	/***
+	 * Record idle time per core and publish load over each window
+	 */
+	void updateLoad();
+
+	/***
+	 * Busy share of a core over the last updates
+	 * @param core
+	 * @param updates - window length, shortened until the history fills
+	 * @return per mille
+	 */
+	uint16_t load(uint8_t core, uint32_t updates);
+
+	/***
+	 * Read the heap_4 free list statistics and publish them with the
+	 * fragmentation index
+	 */
+	void updateHeap();
+
+	/***
+	 * Record the fragmentation index once a report and publish how
+	 * far it has moved over the trend window
+	 */
+	void updateFragTrend();
+
+	uint32_t xTicks = 0;
+	uint32_t xLastSwitches = 0;
+	TaskStatus_t xTaskStatus[TSTMETRICS_MAX_TASKS];
+
+	//Ring of idle time per core and when it was read
+	uint32_t xIdleUs[TSTMETRICS_LOAD_HISTORY][configNUMBER_OF_CORES];
+	uint32_t xLoadUs[TSTMETRICS_LOAD_HISTORY];
+	uint32_t xLoadUpdates = 0;
+
+	//Ring of fragmentation index, one per report
+	uint16_t xFrag[TSTMETRICS_FRAG_TREND];
+	uint32_t xFragReports = 0;
+
+	TaskHandle_t xReportTask = NULL;
+	StaticTask_t xReportTCB;
+	StackType_t xReportStack[TSTMETRICS_REPORT_STACK];
 };
 
 #endif /* EXP_FREERTOSMETRICS_SRC_TSTMETRICS_H_ */
@@ -0,0 +1,92 @@
+/*
+ * TextBuffer.h
+ *
+ * Builds text in a caller supplied buffer using integer and fixed
+ * point maths only. Never allocates and never overruns, text that
+ * does not fit is dropped and the buffer stays terminated.
+ *
+ * Used in place of sprintf so there is no format string to get out of
+ * step with the arguments, no newlib formatter in the image and far
+ * less stack in the caller. exp/2CoreRTOS/tools/format_bench.cpp
+ * compares the two.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef EXP_FREERTOSMETRICS_SRC_TEXTBUFFER_H_
+#define EXP_FREERTOSMETRICS_SRC_TEXTBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+class TextBuffer {
+public:
+	/***
+	 * Constructor
+	 * @param buf - storage, including space for the terminator
+	 * @param size - bytes in buf
+	 */
+	TextBuffer(char *buf, size_t size);
+
+	/***
+	 * Empty the buffer
+	 */
+	void clear();
+
+	TextBuffer &add(const char *s);
+	TextBuffer &add(char c);
+
+	/***
+	 * String padded on the right with spaces
+	 * @param s
+	 * @param width - minimum width
+	 */
+	TextBuffer &add(const char *s, uint8_t width);
+
+	/***
+	 * Unsigned decimal
+	 * @param value
+	 * @param width - minimum width, padded on the left
+	 * @param pad - padding character
+	 */
+	TextBuffer &addUnsigned(uint64_t value, uint8_t width = 0, char pad = ' ');
+
+	/***
+	 * Signed decimal
+	 * @param value
+	 * @param width - minimum width, padded on the left with spaces
+	 */
+	TextBuffer &addSigned(int64_t value, uint8_t width = 0);
+
+	/***
+	 * Fixed point decimal
+	 * @param value - scaled by 10^decimals, so 12345 with 3 is 12.345
+	 * @param decimals - digits after the point
+	 */
+	TextBuffer &addFixed(int64_t value, uint8_t decimals);
+
+	/***
+	 * Hex with leading zeros
+	 * @param value
+	 * @param digits
+	 */
+	TextBuffer &addHex(uint32_t value, uint8_t digits = 8);
+
+	const char *c_str() const;
+	size_t length() const;
+
+	/***
+	 * Was anything dropped for lack of space
+	 * @return
+	 */
+	bool isTruncated() const;
+
+private:
+	char *pBuf;
+	size_t xSize;
+	size_t xLen = 0;
+	bool xTruncated = false;
+};
+
+#endif /* EXP_FREERTOSMETRICS_SRC_TEXTBUFFER_H_ */
@@ -0,0 +1,90 @@
+/*
+ * TimerAgent.cpp
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#include "TimerAgent.h"
+#include <string.h>
+
+/***
+ * Constructor
+ */
+TimerAgent::TimerAgent() {
+	// NOP
+}
+
+/***
+ * Destructor
+ */
+TimerAgent::~TimerAgent() {
+	stop();
+}
+
+/***
+ * Start the timer
+ * @param name - Give the timer a name (<20 characters)
+ * @param periodMs - time between ticks
+ * @return
+ */
+bool TimerAgent::start(const char *name, uint32_t periodMs){
+	if (strlen(name) >= MAX_NAME_LEN){
+		memcpy(pName, name, MAX_NAME_LEN);
+		pName[MAX_NAME_LEN-1]=0;
+	} else {
+		strcpy(pName, name);
+	}
+
+	init();
+
+	xTimer = xTimerCreateStatic(
+		pName,
+		pdMS_TO_TICKS(periodMs),
+		pdTRUE,				/* Auto reload */
+		( void * ) this,	/* Timer ID is the agent */
+		TimerAgent::vTimer,
+		&xTimerBuffer
+	);
+	if (xTimer == NULL){
+		return false;
+	}
+	return (xTimerStart(xTimer, 0) == pdPASS);
+}
+
+/***
+ * Stop timer
+ */
+void TimerAgent::stop(){
+	if (xTimer != NULL){
+		xTimerStop(xTimer, 0);
+		xTimerDelete(xTimer, 0);
+		xTimer = NULL;
+	}
+}
+
+/***
+ * Get the FreeRTOS timer being used
+ * @return
+ */
+TimerHandle_t TimerAgent::getTimer(){
+	return xTimer;
+}
+
+/***
+ * Called once from start, in the caller's context
+ */
+void TimerAgent::init(){
+	// NOP
+}
+
+/***
+ * Timer callback, forwards to tick
+ * @param xTimer
+ */
+void TimerAgent::vTimer( TimerHandle_t xTimer ){
+	TimerAgent *agent = (TimerAgent *) pvTimerGetTimerID(xTimer);
+	if (agent != NULL){
+		agent->tick();
+	}
+}
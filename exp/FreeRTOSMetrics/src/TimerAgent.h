@@ -0,0 +1,77 @@
+/*
+ * TimerAgent.h
+ *
+ * Lightweight agent for short periodic work. Runs as a FreeRTOS
+ * software timer callback on the timer service task, so it needs no
+ * task or stack of its own. tick must not block.
+ *
+ *  Created on: 18 Oct 2026
+ *      Author: jondurrant
+ */
+
+#ifndef SRC_TIMERAGENT_H_
+#define SRC_TIMERAGENT_H_
+
+#include "FreeRTOS.h"
+#include "timers.h"
+
+#ifndef MAX_NAME_LEN
+#define MAX_NAME_LEN 20
+#endif
+
+class TimerAgent {
+public:
+	/***
+	 * Constructor
+	 */
+	TimerAgent();
+
+	/***
+	 * Destructor
+	 */
+	virtual ~TimerAgent();
+
+	/***
+	 * Start the timer
+	 * @param name - Give the timer a name (<20 characters)
+	 * @param periodMs - time between ticks
+	 * @return
+	 */
+	virtual bool start(const char *name, uint32_t periodMs);
+
+	/***
+	 * Stop timer
+	 */
+	virtual void stop();
+
+	/***
+	 * Get the FreeRTOS timer being used
+	 * @return
+	 */
+	virtual TimerHandle_t getTimer();
+
+protected:
+	/***
+	 * Called once from start, in the caller's context
+	 */
+	virtual void init();
+
+	/***
+	 * Periodic work, runs on the timer service task
+	 */
+	virtual void tick()=0;
+
+private:
+	/***
+	 * Timer callback, forwards to tick
+	 * @param xTimer
+	 */
+	static void vTimer( TimerHandle_t xTimer );
+
+	TimerHandle_t xTimer = NULL;
+	StaticTimer_t xTimerBuffer;
+
+	char pName[MAX_NAME_LEN];
+};
+
+#endif /* SRC_TIMERAGENT_H_ */
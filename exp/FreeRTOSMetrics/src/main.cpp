@@ -36,11 +36,12 @@ void main_task(void* params){
  TSTAgent tst;
   tst.start("TST", TASK_PRIORITY);
 
+  //Metrics and Blink run as software timers, not tasks
   TSTMetrics metrics;
-  metrics.start("Metrics", TASK_PRIORITY);
+  metrics.start("Metrics");
 
   BlinkAgent blink;
-  blink.start("Blink", TASK_PRIORITY);
+  blink.start("Blink");
 
 
   for (;;){